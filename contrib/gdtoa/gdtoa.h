@@ -110,6 +110,13 @@ extern char* gdtoa ANSI((FPI *fpi, int be, ULong *bits, int *kindp,
 extern void freedtoa ANSI((char*));
 extern float  strtof ANSI((CONST char *, char **));
 extern double strtod ANSI((CONST char *, char **));
+extern float  strntof ANSI((CONST char *, size_t, char **));
+extern double strntod ANSI((CONST char *, size_t, char **));
+extern int __f2s ANSI((float, char *, int *));
+extern int __d2s ANSI((double, char *, int *));
+extern int __ld2s ANSI((long double, char *, int *));
+extern int __g_efmt ANSI((char *, size_t, double, int, int, int));
+extern int __g_Lefmt ANSI((char *, size_t, long double, int, int, int));
 extern int strtodg ANSI((CONST char*, char**, FPI*, Long*, ULong*));
 
 extern char*	g_ddfmt  ANSI((char*, double*, int, size_t));
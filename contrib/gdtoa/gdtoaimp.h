@@ -484,6 +484,20 @@ extern pthread_mutex_t __gdtoa_locks[2];
 
 #define Kmax 9
 
+/* The scanners (strtod_l, strtodg_l, gethex, hexnan and match) are
+ * told how many bytes n of input are available starting at b, and read
+ * the input only through Inchar(b,n,s): the unsigned character at s, or
+ * 0 once s has reached b + n.  strtod and friends pass n = ~(size_t)0,
+ * so the terminating NUL still ends the scan as before; strntod and
+ * strntof pass the caller's length and never look past it.
+ */
+ static __inline int
+Inchar(CONST void *b, size_t n, CONST void *s)
+{
+	return (size_t)((CONST char*)s - (CONST char*)b) < n
+		? *(CONST unsigned char*)s : 0;
+	}
+
  struct
 Bigint {
 	struct Bigint *next;
@@ -579,6 +593,7 @@ extern void memcpy_D2A ANSI((void*, const void*, size_t));
 #define	set_ones	__set_ones_D2A
 #define	strcp		__strcp_D2A
 #define	strcp_D2A      	__strcp_D2A
+#define	xdtoa	__xdtoa_D2A
 #define	strtoIg		__strtoIg_D2A
 #define	sum		__sum_D2A
 #define	tens		__tens_D2A
@@ -612,15 +627,16 @@ extern void memcpy_D2A ANSI((void*, const void*, size_t));
  extern char *gdtoa ANSI((FPI *fpi, int be, ULong *bits, int *kindp,
 			  int mode, int ndigits, int *decpt, char **rve));
  extern char *g__fmt ANSI((char*, char*, char*, int, ULong, size_t));
- extern int gethex ANSI((CONST char**, FPI*, Long*, Bigint**, int));
+ extern int gethex ANSI((CONST char**, FPI*, Long*, Bigint**, ULong*, int,
+			size_t));
  extern void hexdig_init_D2A(Void);
- extern int hexnan ANSI((CONST char**, FPI*, ULong*));
+ extern int hexnan ANSI((CONST char**, FPI*, ULong*, size_t));
  extern int hi0bits ANSI((ULong));
  extern Bigint *i2b ANSI((int));
  extern Bigint *increment ANSI((Bigint*));
  extern int lo0bits ANSI((ULong*));
  extern Bigint *lshift ANSI((Bigint*, int));
- extern int match ANSI((CONST char**, char*));
+ extern int match ANSI((CONST char**, char*, size_t));
  extern Bigint *mult ANSI((Bigint*, Bigint*));
  extern Bigint *multadd ANSI((Bigint*, int, int));
  extern char *nrv_alloc ANSI((char*, char **, int));
@@ -632,7 +648,9 @@ extern void memcpy_D2A ANSI((void*, const void*, size_t));
  extern Bigint *s2b ANSI((CONST char*, int, int, ULong, int));
  extern Bigint *set_ones ANSI((Bigint*, int));
  extern char *strcp ANSI((char*, const char*));
- extern int strtodg_l ANSI((CONST char*, char**, FPI*, Long*, ULong*, locale_t));
+ extern int strtodg_l ANSI((CONST char*, size_t, char**, FPI*, Long*, ULong*,
+			locale_t));
+ extern int xdtoa ANSI((FPI*, int, ULong*, int, int, int, char*, int*));
 
  extern int strtoId ANSI((CONST char *, char **, double *, double *));
  extern int strtoIdd ANSI((CONST char *, char **, double *, double *));
@@ -35,19 +35,29 @@ THIS SOFTWARE.
 #include "locale.h"
 #endif
 
+ /* If the significand has at most 16 hex digits and fpi->nbits <= 64,
+  * it is assembled and rounded in a ULLong and stored straight into
+  * bits, leaving *bp null; otherwise it is returned in the Bigint *bp.
+  */
+
  int
 #ifdef KR_headers
-gethex(sp, fpi, exp, bp, sign)
-	CONST char **sp; FPI *fpi; Long *exp; Bigint **bp; int sign;
+gethex(sp, fpi, exp, bp, bits, sign, nb)
+	CONST char **sp; FPI *fpi; Long *exp; Bigint **bp; ULong *bits;
+	int sign; size_t nb;
 #else
-gethex( CONST char **sp, FPI *fpi, Long *exp, Bigint **bp, int sign)
+gethex( CONST char **sp, FPI *fpi, Long *exp, Bigint **bp, ULong *bits,
+	int sign, size_t nb)
 #endif
 {
 	Bigint *b;
-	CONST unsigned char *decpt, *s0, *s, *s1;
+	CONST unsigned char *decpt, *s0, *s, *s1, *sb;
 	int big, esign, havedig, irv, j, k, n, n0, nbits, up, zret;
 	ULong L, lostbits, *x;
 	Long e, e1;
+#ifdef ULLong
+	ULLong m, half;
+#endif
 #ifdef USE_LOCALE
 	int i;
 #ifdef NO_LOCALE_CACHE
@@ -70,52 +80,53 @@ gethex( CONST char **sp, FPI *fpi, Long *exp, Bigint **bp, int sign)
 		hexdig_init_D2A();
 	*bp = 0;
 	havedig = 0;
-	s0 = *(CONST unsigned char **)sp + 2;
-	while(s0[havedig] == '0')
+	sb = *(CONST unsigned char **)sp;
+	s0 = sb + 2;
+	while(Inchar(sb, nb, s0 + havedig) == '0')
 		havedig++;
 	s0 += havedig;
 	s = s0;
 	decpt = 0;
 	zret = 0;
 	e = 0;
-	if (hexdig[*s])
+	if (hexdig[Inchar(sb, nb, s)])
 		havedig++;
 	else {
 		zret = 1;
 #ifdef USE_LOCALE
 		for(i = 0; decimalpoint[i]; ++i) {
-			if (s[i] != decimalpoint[i])
+			if (Inchar(sb, nb, s + i) != decimalpoint[i])
 				goto pcheck;
 			}
 		decpt = s += i;
 #else
-		if (*s != '.')
+		if (Inchar(sb, nb, s) != '.')
 			goto pcheck;
 		decpt = ++s;
 #endif
-		if (!hexdig[*s])
+		if (!hexdig[Inchar(sb, nb, s)])
 			goto pcheck;
-		while(*s == '0')
+		while(Inchar(sb, nb, s) == '0')
 			s++;
-		if (hexdig[*s])
+		if (hexdig[Inchar(sb, nb, s)])
 			zret = 0;
 		havedig = 1;
 		s0 = s;
 		}
-	while(hexdig[*s])
+	while(hexdig[Inchar(sb, nb, s)])
 		s++;
 #ifdef USE_LOCALE
-	if (*s == *decimalpoint && !decpt) {
+	if (Inchar(sb, nb, s) == *decimalpoint && !decpt) {
 		for(i = 1; decimalpoint[i]; ++i) {
-			if (s[i] != decimalpoint[i])
+			if (Inchar(sb, nb, s + i) != decimalpoint[i])
 				goto pcheck;
 			}
 		decpt = s += i;
 #else
-	if (*s == '.' && !decpt) {
+	if (Inchar(sb, nb, s) == '.' && !decpt) {
 		decpt = ++s;
 #endif
-		while(hexdig[*s])
+		while(hexdig[Inchar(sb, nb, s)])
 			s++;
 		}/*}*/
 	if (decpt)
@@ -123,22 +134,22 @@ gethex( CONST char **sp, FPI *fpi, Long *exp, Bigint **bp, int sign)
  pcheck:
 	s1 = s;
 	big = esign = 0;
-	switch(*s) {
+	switch(Inchar(sb, nb, s)) {
 	  case 'p':
 	  case 'P':
-		switch(*++s) {
+		switch(Inchar(sb, nb, ++s)) {
 		  case '-':
 			esign = 1;
 			/* no break */
 		  case '+':
 			s++;
 		  }
-		if ((n = hexdig[*s]) == 0 || n > 0x19) {
+		if ((n = hexdig[Inchar(sb, nb, s)]) == 0 || n > 0x19) {
 			s = s1;
 			break;
 			}
 		e1 = n - 0x10;
-		while((n = hexdig[*++s]) !=0 && n <= 0x19) {
+		while((n = hexdig[Inchar(sb, nb, ++s)]) !=0 && n <= 0x19) {
 			if (e1 & 0xf8000000)
 				big = 1;
 			e1 = 10*e1 + n - 0x10;
@@ -198,6 +209,124 @@ gethex( CONST char **sp, FPI *fpi, Long *exp, Bigint **bp, int sign)
 		*exp = fpi->emin;
 		return STRTOG_Normal | STRTOG_Inexlo;
 		}
+#ifdef ULLong /*{*/
+	if (fpi->nbits > 64)
+		goto bigcase;
+	m = 0;
+	for(s = s0, j = 0; s < s1; s++)
+		if ((n = hexdig[*s])) {
+			if (++j > 16)
+				goto bigcase;
+			m = m << 4 | (n & 0x0f);
+			}
+	/* m != 0, as zret is clear */
+	L = (ULong)(m >> 32);
+	n = L ? 64 - hi0bits(L) : 32 - hi0bits((ULong)m);
+	nbits = fpi->nbits;
+	lostbits = 0;
+	if (n > nbits) {
+		n -= nbits;
+		half = (ULLong)1 << (n - 1);
+		if (m & (half | (half - 1))) {
+			lostbits = 1;
+			if (m & half) {
+				lostbits = 2;
+				if (m & (half - 1))
+					lostbits = 3;
+				}
+			}
+		m >>= n;
+		e += n;
+		}
+	else if (n < nbits) {
+		n = nbits - n;
+		m <<= n;
+		e -= n;
+		}
+	if (e > fpi->emax)
+		goto ovfl1;
+	irv = STRTOG_Normal;
+	if (e < fpi->emin) {
+		irv = STRTOG_Denormal;
+		n = fpi->emin - e;
+		if (n >= nbits) {
+			switch (fpi->rounding) {
+			  case FPI_Round_near:
+				if (n == nbits && (n < 2
+				 || m & (((ULLong)1 << (n - 1)) - 1)))
+					goto one_bit64;
+				break;
+			  case FPI_Round_up:
+				if (!sign)
+					goto one_bit64;
+				break;
+			  case FPI_Round_down:
+				if (sign) {
+ one_bit64:
+					bits[0] = 1;
+					if (fpi->nbits > 32)
+						bits[1] = 0;
+					*exp = fpi->emin;
+#ifndef NO_ERRNO
+					errno = ERANGE;
+#endif
+					return STRTOG_Denormal | STRTOG_Inexhi
+						| STRTOG_Underflow;
+					}
+			  }
+			goto retz;
+			}
+		k = n - 1;
+		half = (ULLong)1 << k;
+		if (lostbits)
+			lostbits = 1;
+		else if (k > 0)
+			lostbits = (m & (half - 1)) != 0;
+		if (m & half)
+			lostbits |= 2;
+		nbits -= n;
+		m >>= n;
+		e = fpi->emin;
+		}
+	if (lostbits) {
+		up = 0;
+		switch(fpi->rounding) {
+		  case FPI_Round_zero:
+			break;
+		  case FPI_Round_near:
+			if (lostbits & 2
+			 && (lostbits | (ULong)m) & 1)
+				up = 1;
+			break;
+		  case FPI_Round_up:
+			up = 1 - sign;
+			break;
+		  case FPI_Round_down:
+			up = sign;
+		  }
+		if (up) {
+			m++;
+			if (irv == STRTOG_Denormal) {
+				if (nbits == fpi->nbits - 1 && m >> nbits & 1)
+					irv =  STRTOG_Normal;
+				}
+			else if (m >> nbits) {
+				m >>= 1;
+				if (++e > fpi->emax)
+					goto ovfl1;
+				}
+			irv |= STRTOG_Inexhi;
+			}
+		else
+			irv |= STRTOG_Inexlo;
+		}
+	bits[0] = (ULong)m;
+	if (fpi->nbits > 32)
+		bits[1] = (ULong)(m >> 32);
+	*exp = e;
+	return irv;
+ bigcase:
+#endif /*}*/
 	n = s1 - s0 - 1;
 	for(k = 0; n > (1 << (kshift-2)) - 1; n >>= 1)
 		k++;
@@ -51,14 +51,14 @@ L_shift(ULong *x, ULong *x1, int i)
 
  int
 #ifdef KR_headers
-hexnan(sp, fpi, x0)
-	CONST char **sp; FPI *fpi; ULong *x0;
+hexnan(sp, fpi, x0, n)
+	CONST char **sp; FPI *fpi; ULong *x0; size_t n;
 #else
-hexnan( CONST char **sp, FPI *fpi, ULong *x0)
+hexnan( CONST char **sp, FPI *fpi, ULong *x0, size_t n)
 #endif
 {
 	ULong c, h, *x, *x1, *xe;
-	CONST char *s;
+	CONST char *s, *b;
 	int havedig, hd0, i, nbits;
 
 	if (!hexdig['0'])
@@ -70,14 +70,15 @@ hexnan( CONST char **sp, FPI *fpi, ULong *x0)
 	*--x = 0;
 	x1 = xe = x;
 	havedig = hd0 = i = 0;
-	s = *sp;
+	s = b = *sp;
 	/* allow optional initial 0x or 0X */
-	while((c = *(CONST unsigned char*)(s+1)) && c <= ' ')
+	while((c = Inchar(b, n, s+1)) && c <= ' ')
 		++s;
-	if (s[1] == '0' && (s[2] == 'x' || s[2] == 'X')
-	 && *(CONST unsigned char*)(s+3) > ' ')
+	if (Inchar(b, n, s+1) == '0'
+	 && (Inchar(b, n, s+2) == 'x' || Inchar(b, n, s+2) == 'X')
+	 && Inchar(b, n, s+3) > ' ')
 		s += 2;
-	while((c = *(CONST unsigned char*)++s)) {
+	while((c = Inchar(b, n, ++s))) {
 		if (!(h = hexdig[c])) {
 			if (c <= ' ') {
 				if (hd0 < havedig) {
@@ -92,10 +93,12 @@ hexnan( CONST char **sp, FPI *fpi, ULong *x0)
 					x1 = x;
 					i = 0;
 					}
-				while(*(CONST unsigned char*)(s+1) <= ' ')
+				while((c = Inchar(b, n, s+1)) && c <= ' ')
 					++s;
-				if (s[1] == '0' && (s[2] == 'x' || s[2] == 'X')
-				 && *(CONST unsigned char*)(s+3) > ' ')
+				if (Inchar(b, n, s+1) == '0'
+				 && (Inchar(b, n, s+2) == 'x'
+				  || Inchar(b, n, s+2) == 'X')
+				 && Inchar(b, n, s+3) > ' ')
 					s += 2;
 				continue;
 				}
@@ -109,7 +112,7 @@ hexnan( CONST char **sp, FPI *fpi, ULong *x0)
 					*sp = s + 1;
 					break;
 					}
-				} while((c = *++s));
+				} while((c = Inchar(b, n, ++s)));
 #endif
 			return STRTOG_NaN;
 			}
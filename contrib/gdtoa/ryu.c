@@ -0,0 +1,467 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Shortest round-trip binary to decimal conversion of floats and
+ * doubles, after Ulf Adams, "Ryu: Fast Float-to-String Conversion",
+ * PLDI 2018.  The result is the shortest digit string that reads back
+ * as the same value under round-half-even, and of those the one nearest
+ * the value, so it agrees with dtoa mode 0 without touching a Bigint.
+ */
+
+#include "gdtoaimp.h"
+#include "ryu_tables.h"
+
+#define log10pow2(e) ((int)(((ULong)(e) * 78913) >> 18))
+#define log10pow5(e) ((int)(((ULong)(e) * 732923) >> 20))
+#define pow5bits(e) ((int)((((ULong)(e) * 1217359) >> 19) + 1))
+
+ static int
+#ifdef KR_headers
+pow5factor(v) ULLong v;
+#else
+pow5factor(ULLong v)
+#endif
+{
+	int n;
+
+	for(n = 0; v % 5 == 0; v /= 5)
+		n++;
+	return n;
+	}
+
+#define multiple_of_pow5(v, p) (pow5factor(v) >= (p))
+#define multiple_of_pow2(v, p) (((v) & (((ULLong)1 << (p)) - 1)) == 0)
+
+#ifndef __SIZEOF_INT128__
+/* high 64 bits of the product a * b */
+
+ static ULLong
+#ifdef KR_headers
+umulh(a, b) ULLong a, b;
+#else
+umulh(ULLong a, ULLong b)
+#endif
+{
+	ULLong a0, a1, b0, b1, mid, t;
+
+	a0 = a & 0xffffffff;
+	a1 = a >> 32;
+	b0 = b & 0xffffffff;
+	b1 = b >> 32;
+	t = a0 * b0;
+	mid = a1 * b0 + (t >> 32);
+	t = a0 * b1 + (mid & 0xffffffff);
+	return a1 * b1 + (mid >> 32) + (t >> 32);
+	}
+#endif
+
+/* (m * mul) >> j, for 64 < j < 128, mul being a 128-bit table entry */
+
+ static ULLong
+#ifdef KR_headers
+mulshift64(m, mul, j) ULLong m; CONST ULLong *mul; int j;
+#else
+mulshift64(ULLong m, CONST ULLong *mul, int j)
+#endif
+{
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 b0, b2;
+
+	b0 = (unsigned __int128)m * mul[0];
+	b2 = (unsigned __int128)m * mul[1];
+	return (ULLong)(((b0 >> 64) + b2) >> (j - 64));
+#else
+	ULLong hi, lo, t;
+
+	t = umulh(m, mul[0]);
+	lo = m * mul[1];
+	hi = umulh(m, mul[1]);
+	lo += t;
+	if (lo < t)
+		hi++;
+	j -= 64;
+	return hi << (64 - j) | lo >> j;
+#endif
+	}
+
+/* Store the decimal digits of v, which has nd of them, in buf. */
+
+ static void
+#ifdef KR_headers
+putdigits(buf, v, nd) char *buf; ULLong v; int nd;
+#else
+putdigits(char *buf, ULLong v, int nd)
+#endif
+{
+	buf[nd] = 0;
+	while(nd > 0) {
+		buf[--nd] = '0' + (int)(v % 10);
+		v /= 10;
+		}
+	}
+
+ static int
+#ifdef KR_headers
+ndigits(v) ULLong v;
+#else
+ndigits(ULLong v)
+#endif
+{
+	int n;
+
+	for(n = 1; v >= 10; v /= 10)
+		n++;
+	return n;
+	}
+
+/* Common tail of the conversions: value = output * 10**e10. */
+
+ static int
+#ifdef KR_headers
+ryu_out(buf, decpt, output, e10) char *buf; int *decpt; ULLong output; int e10;
+#else
+ryu_out(char *buf, int *decpt, ULLong output, int e10)
+#endif
+{
+	int nd;
+
+	nd = ndigits(output);
+	putdigits(buf, output, nd);
+	*decpt = e10 + nd;
+	return nd;
+	}
+
+ static int
+#ifdef KR_headers
+ryu_special(buf, decpt, nan) char *buf; int *decpt; int nan;
+#else
+ryu_special(char *buf, int *decpt, int nan)
+#endif
+{
+	*decpt = 9999;
+	strcpy(buf, nan ? "NaN" : "Infinity");
+	return nan ? 3 : 8;
+	}
+
+/* Store the shortest round-trip decimal digits of |d| in buf, which must
+ * have room for 18 characters, NUL-terminated and without trailing
+ * zeros.  Returns the number of digits; the value is 0.digits * 10**decpt
+ * as with dtoa, and as there an Infinity or NaN gives decpt = 9999.
+ */
+
+ int
+#ifdef KR_headers
+__d2s(d, buf, decpt) double d; char *buf; int *decpt;
+#else
+__d2s(double d, char *buf, int *decpt)
+#endif
+{
+	U u;
+	ULLong mant, m2, mv, vm, vp, vr, output;
+	ULong ex;
+	int accept, e10, e2, i, j, k, last, mmshift, q, removed, roundup;
+	int vmzeros, vrzeros;
+
+	dval(&u) = d;
+	mant = (ULLong)(word0(&u) & Frac_mask) << 32 | word1(&u);
+	ex = (word0(&u) & Exp_mask) >> Exp_shift;
+	if (ex == 0x7ff)
+		return ryu_special(buf, decpt, mant != 0);
+	if (ex == 0 && mant == 0) {
+		buf[0] = '0';
+		buf[1] = 0;
+		*decpt = 1;
+		return 1;
+		}
+	if (ex == 0) {
+		e2 = 1 - Bias - (P - 1) - 2;
+		m2 = mant;
+		}
+	else {
+		e2 = (int)ex - Bias - (P - 1) - 2;
+		m2 = (ULLong)1 << (P - 1) | mant;
+		}
+	accept = (m2 & 1) == 0;
+	mv = 4 * m2;
+	mmshift = mant != 0 || ex <= 1;
+	vmzeros = vrzeros = 0;
+
+	/* Step 3: the interval of valid decimal representations, scaled
+	 * by 10**-e10, in vm < vr < vp.
+	 */
+	if (e2 >= 0) {
+		q = log10pow2(e2) - (e2 > 3);
+		e10 = q;
+		k = POW5_INV_BITCOUNT + pow5bits(q) - 1;
+		i = -e2 + q + k;
+		vr = mulshift64(4 * m2, pow5_inv_split[q], i);
+		vp = mulshift64(4 * m2 + 2, pow5_inv_split[q], i);
+		vm = mulshift64(4 * m2 - 1 - mmshift, pow5_inv_split[q], i);
+		if (q <= 21) {
+			/* Only then can one of them be exactly divisible. */
+			if (mv % 5 == 0)
+				vrzeros = multiple_of_pow5(mv, q);
+			else if (accept)
+				vmzeros = multiple_of_pow5(mv - 1 - mmshift, q);
+			else
+				vp -= multiple_of_pow5(mv + 2, q);
+			}
+		}
+	else {
+		q = log10pow5(-e2) - (-e2 > 1);
+		e10 = q + e2;
+		i = -e2 - q;
+		k = pow5bits(i) - POW5_BITCOUNT;
+		j = q - k;
+		vr = mulshift64(4 * m2, pow5_split[i], j);
+		vp = mulshift64(4 * m2 + 2, pow5_split[i], j);
+		vm = mulshift64(4 * m2 - 1 - mmshift, pow5_split[i], j);
+		if (q <= 1) {
+			/* mv has at least q trailing 0 bits, as does vr. */
+			vrzeros = 1;
+			if (accept)
+				vmzeros = mmshift == 1;
+			else
+				--vp;
+			}
+		else if (q < 63)
+			vrzeros = multiple_of_pow2(mv, q);
+		}
+
+	/* Step 4: drop digits while vm and vp still differ. */
+	removed = last = 0;
+	if (vmzeros || vrzeros) {
+		/* Rare: the exact ends of the interval matter. */
+		while(vp / 10 > vm / 10) {
+			vmzeros &= vm % 10 == 0;
+			vrzeros &= last == 0;
+			last = (int)(vr % 10);
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			removed++;
+			}
+		if (vmzeros)
+			while(vm % 10 == 0) {
+				vrzeros &= last == 0;
+				last = (int)(vr % 10);
+				vr /= 10;
+				vp /= 10;
+				vm /= 10;
+				removed++;
+				}
+		if (vrzeros && last == 5 && vr % 2 == 0)
+			last = 4;	/* round half even */
+		output = vr + ((vr == vm && (!accept || !vmzeros)) || last >= 5);
+		}
+	else {
+		roundup = 0;
+		if (vp / 100 > vm / 100) {
+			roundup = vr % 100 >= 50;
+			vr /= 100;
+			vp /= 100;
+			vm /= 100;
+			removed += 2;
+			}
+		while(vp / 10 > vm / 10) {
+			roundup = vr % 10 >= 5;
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			removed++;
+			}
+		output = vr + (vr == vm || roundup);
+		}
+	return ryu_out(buf, decpt, output, e10 + removed);
+	}
+
+/* (m * factor) >> shift, for shift > 32 */
+
+ static ULong
+#ifdef KR_headers
+mulshift32(m, factor, shift) ULong m; ULLong factor; int shift;
+#else
+mulshift32(ULong m, ULLong factor, int shift)
+#endif
+{
+	ULLong b0, b1;
+
+	b0 = (ULLong)m * (ULong)factor;
+	b1 = (ULLong)m * (ULong)(factor >> 32);
+	return (ULong)(((b0 >> 32) + b1) >> (shift - 32));
+	}
+
+/* The float conversion uses the top 64 bits of the double tables. The
+ * inverse entries are floor(2^x / 5^y) + 1 truncated, so the 1 that the
+ * truncation lost has to be put back.
+ */
+#define FPOW5_INV_BITCOUNT (POW5_INV_BITCOUNT - 64)
+#define FPOW5_BITCOUNT (POW5_BITCOUNT - 64)
+#define mulpow5inv(m, q, j) mulshift32(m, pow5_inv_split[q][1] + 1, j)
+#define mulpow5(m, i, j) mulshift32(m, pow5_split[i][1], j)
+
+ static int
+#ifdef KR_headers
+pow5factor32(v) ULong v;
+#else
+pow5factor32(ULong v)
+#endif
+{
+	int n;
+
+	for(n = 0; v % 5 == 0; v /= 5)
+		n++;
+	return n;
+	}
+
+/* __d2s for a float; buf needs room for 10 characters. */
+
+ int
+#ifdef KR_headers
+__f2s(f, buf, decpt) float f; char *buf; int *decpt;
+#else
+__f2s(float f, char *buf, int *decpt)
+#endif
+{
+	union { float f; ULong L; } u;
+	ULong mant, m2, mm, mp, mv, vm, vp, vr, ex;
+	int accept, e10, e2, i, j, k, last, mmshift, q, removed;
+	int vmzeros, vrzeros;
+
+	u.f = f;
+	mant = u.L & 0x7fffff;
+	ex = u.L >> 23 & 0xff;
+	if (ex == 0xff)
+		return ryu_special(buf, decpt, mant != 0);
+	if (ex == 0 && mant == 0) {
+		buf[0] = '0';
+		buf[1] = 0;
+		*decpt = 1;
+		return 1;
+		}
+	if (ex == 0) {
+		e2 = 1 - 127 - 23 - 2;
+		m2 = mant;
+		}
+	else {
+		e2 = (int)ex - 127 - 23 - 2;
+		m2 = (ULong)1 << 23 | mant;
+		}
+	accept = (m2 & 1) == 0;
+	mv = 4 * m2;
+	mp = 4 * m2 + 2;
+	mmshift = mant != 0 || ex <= 1;
+	mm = 4 * m2 - 1 - mmshift;
+	vmzeros = vrzeros = 0;
+	last = 0;
+	if (e2 >= 0) {
+		q = log10pow2(e2);
+		e10 = q;
+		k = FPOW5_INV_BITCOUNT + pow5bits(q) - 1;
+		i = -e2 + q + k;
+		vr = mulpow5inv(mv, q, i);
+		vp = mulpow5inv(mp, q, i);
+		vm = mulpow5inv(mm, q, i);
+		if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+			/* We need the digit below vr even though the
+			 * loop below may not remove any.
+			 */
+			k = FPOW5_INV_BITCOUNT + pow5bits(q - 1) - 1;
+			last = (int)(mulpow5inv(mv, q - 1,
+				-e2 + q - 1 + k) % 10);
+			}
+		if (q <= 9) {
+			if (mv % 5 == 0)
+				vrzeros = pow5factor32(mv) >= q;
+			else if (accept)
+				vmzeros = pow5factor32(mm) >= q;
+			else
+				vp -= pow5factor32(mp) >= q;
+			}
+		}
+	else {
+		q = log10pow5(-e2);
+		e10 = q + e2;
+		i = -e2 - q;
+		k = pow5bits(i) - FPOW5_BITCOUNT;
+		j = q - k;
+		vr = mulpow5(mv, i, j);
+		vp = mulpow5(mp, i, j);
+		vm = mulpow5(mm, i, j);
+		if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+			j = q - 1 - (pow5bits(i + 1) - FPOW5_BITCOUNT);
+			last = (int)(mulpow5(mv, i + 1, j) % 10);
+			}
+		if (q <= 1) {
+			vrzeros = 1;
+			if (accept)
+				vmzeros = mmshift == 1;
+			else
+				--vp;
+			}
+		else if (q < 31)
+			vrzeros = (mv & (((ULong)1 << (q - 1)) - 1)) == 0;
+		}
+	removed = 0;
+	if (vmzeros || vrzeros) {
+		while(vp / 10 > vm / 10) {
+			vmzeros &= vm % 10 == 0;
+			vrzeros &= last == 0;
+			last = (int)(vr % 10);
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			removed++;
+			}
+		if (vmzeros)
+			while(vm % 10 == 0) {
+				vrzeros &= last == 0;
+				last = (int)(vr % 10);
+				vr /= 10;
+				vp /= 10;
+				vm /= 10;
+				removed++;
+				}
+		if (vrzeros && last == 5 && vr % 2 == 0)
+			last = 4;	/* round half even */
+		vr += (vr == vm && (!accept || !vmzeros)) || last >= 5;
+		}
+	else {
+		while(vp / 10 > vm / 10) {
+			last = (int)(vr % 10);
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			removed++;
+			}
+		vr += vr == vm || last >= 5;
+		}
+	return ryu_out(buf, decpt, vr, e10 + removed);
+	}
@@ -111,16 +111,17 @@ ratio
  int
 match
 #ifdef KR_headers
-	(sp, t) char **sp, *t;
+	(sp, t, n) char **sp, *t; size_t n;
 #else
-	(CONST char **sp, char *t)
+	(CONST char **sp, char *t, size_t n)
 #endif
 {
 	int c, d;
-	CONST char *s = *sp;
+	CONST char *s = *sp, *s0 = *sp;
 
 	while( (d = *t++) !=0) {
-		if ((c = *++s) >= 'A' && c <= 'Z')
+		++s;
+		if ((c = Inchar(s0, n, s)) >= 'A' && c <= 'Z')
 			c += 'a' - 'A';
 		if (c != d)
 			return 0;
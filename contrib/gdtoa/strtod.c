@@ -84,9 +84,9 @@ sulp
 static double
 strtod_l
 #ifdef KR_headers
-	(s00, se, loc) CONST char *s00; char **se; locale_t loc
+	(s00, n, se, loc) CONST char *s00; size_t n; char **se; locale_t loc
 #else
-	(CONST char *s00, char **se, locale_t loc)
+	(CONST char *s00, size_t n, char **se, locale_t loc)
 #endif
 {
 #ifdef Avoid_Underflow
@@ -94,7 +94,7 @@ strtod_l
 #endif
 	int bb2, bb5, bbe, bd2, bd5, bbbits, bs2, c, decpt, dsign,
 		 e, e1, esign, i, j, k, nd, nd0, nf, nz, nz0, sign;
-	CONST char *s, *s0, *s1;
+	CONST char *s, *s0, *s1, *sb;
 	double aadj;
 	Long L;
 	U adj, aadj1, rv, rv0;
@@ -144,12 +144,13 @@ strtod_l
 
 	sign = nz0 = nz = decpt = 0;
 	dval(&rv) = 0.;
-	for(s = s00;;s++) switch(*s) {
+	sb = s00;
+	for(s = s00;;s++) switch(Inchar(sb, n, s)) {
 		case '-':
 			sign = 1;
 			/* no break */
 		case '+':
-			if (*++s)
+			if (Inchar(sb, n, ++s))
 				goto break2;
 			/* no break */
 		case 0:
@@ -165,13 +166,13 @@ strtod_l
 			goto break2;
 		}
  break2:
-	if (*s == '0') {
+	if (Inchar(sb, n, s) == '0') {
 #ifndef NO_HEX_FP /*{*/
 		{
 		static FPI fpi = { 53, 1-1023-53+1, 2046-1023-53+1, 1, SI };
 		Long exp;
 		ULong bits[2];
-		switch(s[1]) {
+		switch(Inchar(sb, n, s+1)) {
 		  case 'x':
 		  case 'X':
 			{
@@ -181,7 +182,8 @@ strtod_l
 #else
 #define fpi1 fpi
 #endif
-			switch((i = gethex(&s, &fpi1, &exp, &bb, sign)) & STRTOG_Retmask) {
+			switch((i = gethex(&s, &fpi1, &exp, &bb, bits, sign,
+					n - (s - sb))) & STRTOG_Retmask) {
 			  case STRTOG_NoNumber:
 				s = s00;
 				sign = 0;
@@ -199,13 +201,13 @@ strtod_l
 		}
 #endif /*}*/
 		nz0 = 1;
-		while(*++s == '0') ;
-		if (!*s)
+		while(Inchar(sb, n, ++s) == '0') ;
+		if (!Inchar(sb, n, s))
 			goto ret;
 		}
 	s0 = s;
 	y = z = 0;
-	for(nd = nf = 0; (c = *s) >= '0' && c <= '9'; nd++, s++)
+	for(nd = nf = 0; (c = Inchar(sb, n, s)) >= '0' && c <= '9'; nd++, s++)
 		if (nd < 9)
 			y = 10*y + c - '0';
 		else if (nd < 16)
@@ -214,17 +216,17 @@ strtod_l
 #ifdef USE_LOCALE
 	if (c == *decimalpoint) {
 		for(i = 1; decimalpoint[i]; ++i)
-			if (s[i] != decimalpoint[i])
+			if (Inchar(sb, n, s+i) != decimalpoint[i])
 				goto dig_done;
 		s += i;
-		c = *s;
+		c = Inchar(sb, n, s);
 #else
 	if (c == '.') {
-		c = *++s;
+		c = Inchar(sb, n, ++s);
 #endif
 		decpt = 1;
 		if (!nd) {
-			for(; c == '0'; c = *++s)
+			for(; c == '0'; c = Inchar(sb, n, ++s))
 				nz++;
 			if (c > '0' && c <= '9') {
 				s0 = s;
@@ -234,7 +236,7 @@ strtod_l
 				}
 			goto dig_done;
 			}
-		for(; c >= '0' && c <= '9'; c = *++s) {
+		for(; c >= '0' && c <= '9'; c = Inchar(sb, n, ++s)) {
  have_dig:
 			nz++;
 			if (c -= '0') {
@@ -260,19 +262,19 @@ strtod_l
 			}
 		s00 = s;
 		esign = 0;
-		switch(c = *++s) {
+		switch(c = Inchar(sb, n, ++s)) {
 			case '-':
 				esign = 1;
 			case '+':
-				c = *++s;
+				c = Inchar(sb, n, ++s);
 			}
 		if (c >= '0' && c <= '9') {
 			while(c == '0')
-				c = *++s;
+				c = Inchar(sb, n, ++s);
 			if (c > '0' && c <= '9') {
 				L = c - '0';
 				s1 = s;
-				while((c = *++s) >= '0' && c <= '9')
+				while((c = Inchar(sb, n, ++s)) >= '0' && c <= '9')
 					L = 10*L + c - '0';
 				if (s - s1 > 8 || L > 19999)
 					/* Avoid confusion from exponents
@@ -301,9 +303,9 @@ strtod_l
 			 switch(c) {
 			  case 'i':
 			  case 'I':
-				if (match(&s,"nf")) {
+				if (match(&s,"nf", n - (s - sb))) {
 					--s;
-					if (!match(&s,"inity"))
+					if (!match(&s,"inity", n - (s - sb)))
 						++s;
 					word0(&rv) = 0x7ff00000;
 					word1(&rv) = 0;
@@ -312,10 +314,10 @@ strtod_l
 				break;
 			  case 'n':
 			  case 'N':
-				if (match(&s, "an")) {
+				if (match(&s, "an", n - (s - sb))) {
 #ifndef No_Hex_NaN
-					if (*s == '(' /*)*/
-					 && hexnan(&s, &fpinan, bits)
+					if (Inchar(sb, n, s) == '(' /*)*/
+					 && hexnan(&s, &fpinan, bits, n - (s - sb))
 							== STRTOG_NaNbits) {
 						word0(&rv) = 0x7ff80000 | bits[1];
 						word1(&rv) = bits[0];
@@ -1082,6 +1084,20 @@ strtod
 	(CONST char *s00, char **se)
 #endif
 {
-	return strtod_l(s00, se, 0);
+	return strtod_l(s00, ~(size_t)0, se, 0);
+}
+
+/* Like strtod, but examines at most the first n bytes of s00, which
+ * need not be NUL-terminated (e.g. a field of a memory-mapped file).
+ */
+ double
+strntod
+#ifdef KR_headers
+	(s00, n, se) CONST char *s00; size_t n; char **se;
+#else
+	(CONST char *s00, size_t n, char **se)
+#endif
+{
+	return strtod_l(s00, n, se, 0);
 }
 
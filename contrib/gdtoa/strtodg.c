@@ -315,10 +315,12 @@ mantbits(U *d)
  int
 strtodg_l
 #ifdef KR_headers
-	(s00, se, fpi, exp, bits, loc)
-	CONST char *s00; char **se; FPI *fpi; Long *exp; ULong *bits; locale_t loc;
+	(s00, n, se, fpi, exp, bits, loc)
+	CONST char *s00; size_t n; char **se; FPI *fpi; Long *exp; ULong *bits;
+	locale_t loc;
 #else
-	(CONST char *s00, char **se, FPI *fpi, Long *exp, ULong *bits, locale_t loc)
+	(CONST char *s00, size_t n, char **se, FPI *fpi, Long *exp, ULong *bits,
+	 locale_t loc)
 #endif
 {
 	int abe, abits, asub;
@@ -326,7 +328,7 @@ strtodg_l
 	int dsign, e, e1, e2, emin, esign, finished, i, inex, irv;
 	int j, k, nbits, nd, nd0, nf, nz, nz0, rd, rvbits, rve, rve1, sign;
 	int sudden_underflow;
-	CONST char *s, *s0, *s1;
+	CONST char *s, *s0, *s1, *sb;
 	double adj0, tol;
 	Long L;
 	U adj, rv;
@@ -359,12 +361,13 @@ strtodg_l
 	dval(&rv) = 0.;
 	rvb = 0;
 	nbits = fpi->nbits;
-	for(s = s00;;s++) switch(*s) {
+	sb = s00;
+	for(s = s00;;s++) switch(Inchar(sb, n, s)) {
 		case '-':
 			sign = 1;
 			/* no break */
 		case '+':
-			if (*++s)
+			if (Inchar(sb, n, ++s))
 				goto break2;
 			/* no break */
 		case 0:
@@ -383,12 +386,13 @@ strtodg_l
 			goto break2;
 		}
  break2:
-	if (*s == '0') {
+	if (Inchar(sb, n, s) == '0') {
 #ifndef NO_HEX_FP
-		switch(s[1]) {
+		switch(Inchar(sb, n, s+1)) {
 		  case 'x':
 		  case 'X':
-			irv = gethex(&s, fpi, exp, &rvb, sign);
+			irv = gethex(&s, fpi, exp, &rvb, bits, sign,
+			    n - (s - sb));
 			if (irv == STRTOG_NoNumber) {
 				s = s00;
 				sign = 0;
@@ -397,14 +401,15 @@ strtodg_l
 		  }
 #endif
 		nz0 = 1;
-		while(*++s == '0') ;
-		if (!*s)
+		while(Inchar(sb, n, ++s) == '0') ;
+		if (!Inchar(sb, n, s))
 			goto ret;
 		}
 	sudden_underflow = fpi->sudden_underflow;
 	s0 = s;
 	y = z = 0;
-	for(decpt = nd = nf = 0; (c = *s) >= '0' && c <= '9'; nd++, s++)
+	for(decpt = nd = nf = 0; (c = Inchar(sb, n, s)) >= '0' && c <= '9';
+	    nd++, s++)
 		if (nd < 9)
 			y = 10*y + c - '0';
 		else if (nd < 16)
@@ -413,17 +418,17 @@ strtodg_l
 #ifdef USE_LOCALE
 	if (c == *decimalpoint) {
 		for(i = 1; decimalpoint[i]; ++i)
-			if (s[i] != decimalpoint[i])
+			if (Inchar(sb, n, s+i) != decimalpoint[i])
 				goto dig_done;
 		s += i;
-		c = *s;
+		c = Inchar(sb, n, s);
 #else
 	if (c == '.') {
-		c = *++s;
+		c = Inchar(sb, n, ++s);
 #endif
 		decpt = 1;
 		if (!nd) {
-			for(; c == '0'; c = *++s)
+			for(; c == '0'; c = Inchar(sb, n, ++s))
 				nz++;
 			if (c > '0' && c <= '9') {
 				s0 = s;
@@ -433,7 +438,7 @@ strtodg_l
 				}
 			goto dig_done;
 			}
-		for(; c >= '0' && c <= '9'; c = *++s) {
+		for(; c >= '0' && c <= '9'; c = Inchar(sb, n, ++s)) {
  have_dig:
 			nz++;
 			if (c -= '0') {
@@ -457,23 +462,24 @@ strtodg_l
 		if (!nd && !nz && !nz0) {
 			irv = STRTOG_NoNumber;
 			s = s00;
+			sign = 0;
 			goto ret;
 			}
 		s00 = s;
 		esign = 0;
-		switch(c = *++s) {
+		switch(c = Inchar(sb, n, ++s)) {
 			case '-':
 				esign = 1;
 			case '+':
-				c = *++s;
+				c = Inchar(sb, n, ++s);
 			}
 		if (c >= '0' && c <= '9') {
 			while(c == '0')
-				c = *++s;
+				c = Inchar(sb, n, ++s);
 			if (c > '0' && c <= '9') {
 				L = c - '0';
 				s1 = s;
-				while((c = *++s) >= '0' && c <= '9')
+				while((c = Inchar(sb, n, ++s)) >= '0' && c <= '9')
 					L = 10*L + c - '0';
 				if (s - s1 > 8 || L > 19999)
 					/* Avoid confusion from exponents
@@ -499,9 +505,9 @@ strtodg_l
 			 switch(c) {
 			  case 'i':
 			  case 'I':
-				if (match(&s,"nf")) {
+				if (match(&s,"nf", n - (s - sb))) {
 					--s;
-					if (!match(&s,"inity"))
+					if (!match(&s,"inity", n - (s - sb)))
 						++s;
 					irv = STRTOG_Infinite;
 					goto infnanexp;
@@ -509,12 +515,13 @@ strtodg_l
 				break;
 			  case 'n':
 			  case 'N':
-				if (match(&s, "an")) {
+				if (match(&s, "an", n - (s - sb))) {
 					irv = STRTOG_NaN;
 					*exp = fpi->emax + 1;
 #ifndef No_Hex_NaN
-					if (*s == '(') /*)*/
-						irv = hexnan(&s, fpi, bits);
+					if (Inchar(sb, n, s) == '(') /*)*/
+						irv = hexnan(&s, fpi, bits,
+						    n - (s - sb));
 #endif
 					goto infnanexp;
 					}
@@ -522,6 +529,7 @@ strtodg_l
 #endif /* INFNAN_CHECK */
 			irv = STRTOG_NoNumber;
 			s = s00;
+			sign = 0;
 			}
 		goto ret;
 		}
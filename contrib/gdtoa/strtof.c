@@ -35,9 +35,9 @@ THIS SOFTWARE.
 
 static float
 #ifdef KR_headers
-strtof_l(s, sp, loc) CONST char *s; char **sp; locale_t loc;
+strtof_l(s, n, sp, loc) CONST char *s; size_t n; char **sp; locale_t loc;
 #else
-strtof_l(CONST char *s, char **sp, locale_t loc)
+strtof_l(CONST char *s, size_t n, char **sp, locale_t loc)
 #endif
 {
 	static FPI fpi0 = { 24, 1-127-24+1,  254-127-24+1, 1, SI };
@@ -51,7 +51,7 @@ strtof_l(CONST char *s, char **sp, locale_t loc)
 #define fpi &fpi0
 #endif
 
-	k = strtodg_l(s, sp, fpi, &exp, bits, loc);
+	k = strtodg_l(s, n, sp, fpi, &exp, bits, loc);
 	switch(k & STRTOG_Retmask) {
 	  case STRTOG_NoNumber:
 	  case STRTOG_Zero:
@@ -90,6 +90,19 @@ strtof(CONST char *s, char **sp)
 #endif
 {
 	// return strtof_l(s, sp, __get_locale());
-	return strtof_l(s, sp, NULL);
+	return strtof_l(s, ~(size_t)0, sp, NULL);
+}
+
+/* Like strtof, but examines at most the first n bytes of s, which need
+ * not be NUL-terminated.
+ */
+ float
+#ifdef KR_headers
+strntof(s, n, sp) CONST char *s; size_t n; char **sp;
+#else
+strntof(CONST char *s, size_t n, char **sp)
+#endif
+{
+	return strtof_l(s, n, sp, NULL);
 }
 
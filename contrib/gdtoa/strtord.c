@@ -88,7 +88,7 @@ strtord_l(CONST char *s, char **sp, int rounding, double *d, locale_t locale)
 		fpi1.rounding = rounding;
 		fpi = &fpi1;
 		}
-	k = strtodg_l(s, sp, fpi, &exp, bits, locale);
+	k = strtodg_l(s, ~(size_t)0, sp, fpi, &exp, bits, locale);
 	ULtod((ULong*)d, bits, exp, k);
 	return k;
 	}
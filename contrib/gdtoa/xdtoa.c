@@ -0,0 +1,313 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Exact binary to decimal conversion with Bigints, for any format that
+ * an FPI describes.  This is the slow path behind ryu.c: it serves
+ * formats Ryu has no tables for (long double) and requests for a fixed
+ * number of correctly rounded digits, which printf's %e and %g need.
+ */
+
+#include "gdtoaimp.h"
+
+/* floor(t * log10(2)), give or take one; xdtoa corrects the estimate. */
+
+ static int
+#ifdef KR_headers
+est10(t) int t;
+#else
+est10(int t)
+#endif
+{
+	if (t >= 0)
+		return (int)(((ULLong)t * 78913) >> 18);
+	return -(int)(((ULLong)-t * 78913 + 262143) >> 18);
+	}
+
+ static Bigint *
+#ifdef KR_headers
+bdup(b) Bigint *b;
+#else
+bdup(Bigint *b)
+#endif
+{
+	Bigint *b1;
+
+	b1 = Balloc(b->k);
+	Bcopy(b1, b);
+	return b1;
+	}
+
+ static Bigint *
+#ifdef KR_headers
+pow10mult(b, k) Bigint *b; int k;
+#else
+pow10mult(Bigint *b, int k)
+#endif
+{
+	return lshift(pow5mult(b, k), k);
+	}
+
+#define mul10(b) multadd(b, 10, 0)
+#define iszero(b) ((b)->wds == 1 && (b)->x[0] == 0)
+
+/* Return floor(b/S), which must be below 10, leaving the remainder in b. */
+
+ static int
+#ifdef KR_headers
+qdigit(b, S) Bigint *b, *S;
+#else
+qdigit(Bigint *b, Bigint *S)
+#endif
+{
+	ULLong borrow, carry, y, ys;
+	ULong *bx, *sx;
+	int i, n, q, q1;
+
+	n = S->wds;
+	if (b->wds < n)
+		return 0;
+	bx = b->x;
+	sx = S->x;
+	/* The leading words give an estimate that is never too big. */
+	y = bx[n-1];
+	if (b->wds > n)
+		y |= (ULLong)bx[n] << 32;
+	q = (int)(y / ((ULLong)sx[n-1] + 1));
+	for(q1 = q;; q1 = 1) {
+		if (q1) {
+			borrow = carry = 0;
+			for(i = 0; i < b->wds; i++) {
+				ys = (i < n ? sx[i] * (ULLong)q1 : 0) + carry;
+				carry = ys >> 32;
+				y = bx[i] - (ys & 0xffffffffUL) - borrow;
+				borrow = y >> 32 & 1UL;
+				bx[i] = (ULong)y;
+				}
+			while(b->wds > 1 && !bx[b->wds - 1])
+				b->wds--;
+			}
+		if (cmp(b, S) < 0)
+			break;
+		q++;
+		}
+	return q;
+	}
+
+/* Convert bits * 2**be, with fpi->nbits significant bits at most, to
+ * decimal.  Mode 0 gives the shortest digit string that reads back as
+ * the same value (with round-half-even reading); mode 2 gives max(1,
+ * ndigits) digits rounded as fpi->rounding says, sign telling which way
+ * is up.  The digits go to buf, NUL-terminated and without trailing
+ * zeros, and the value is 0.digits * 10**decpt.  The number of digits
+ * is returned.  buf needs room for ndigits + 1 characters in mode 2 and
+ * for 2 + the format's decimal precision + 1 in mode 0.
+ */
+
+ int
+#ifdef KR_headers
+xdtoa(fpi, be, bits, sign, mode, ndigits, buf, decpt)
+	FPI *fpi; int be; ULong *bits; int sign, mode, ndigits; char *buf;
+	int *decpt;
+#else
+xdtoa(FPI *fpi, int be, ULong *bits, int sign, int mode, int ndigits,
+	char *buf, int *decpt)
+#endif
+{
+	Bigint *b, *mhi, *mlo, *S, *t, *u;
+	int bl, dig, even, i, j, j1, k, nd, nw, tc1, tc2, unequal, up;
+
+	nw = (fpi->nbits + 31) >> 5;
+	b = Balloc(nw > 1 ? (nw > 2 ? (nw > 4 ? 3 : 2) : 1) : 0);
+	for(i = 0; i < nw; i++)
+		b->x[i] = bits[i];
+	if (fpi->nbits & 31)
+		b->x[nw - 1] &= (1UL << (fpi->nbits & 31)) - 1;
+	while(nw > 1 && !b->x[nw - 1])
+		nw--;
+	b->wds = nw;
+	if (iszero(b)) {
+		Bfree(b);
+		buf[0] = '0';
+		buf[1] = 0;
+		*decpt = 1;
+		return 1;
+		}
+	bl = 32*nw - hi0bits(b->x[nw - 1]);
+	k = est10(be + bl - 1);
+	mhi = mlo = 0;
+	even = !(b->x[0] & 1);
+
+	/* value = b/S; in mode 0 the values that read back as it lie
+	 * strictly between (b - mlo)/S and (b + mhi)/S, or inclusively
+	 * if the significand is even.
+	 */
+	if (mode == 0) {
+		/* The gap below a power of 2 is half the one above it. */
+		unequal = bl == fpi->nbits && be > fpi->emin
+			&& !(b->x[nw - 1] & (b->x[nw - 1] - 1));
+		for(i = 0; unequal && i < nw - 1; i++)
+			unequal = !b->x[i];
+		j = unequal ? 2 : 1;
+		if (be >= 0) {
+			S = i2b(2*j);
+			mlo = lshift(i2b(1), be);
+			mhi = lshift(i2b(j), be);
+			b = lshift(b, be + j);
+			}
+		else {
+			S = lshift(i2b(1), -be + j);
+			mlo = i2b(1);
+			mhi = i2b(j);
+			b = lshift(b, j);
+			}
+		}
+	else {
+		if (be >= 0) {
+			S = i2b(1);
+			if (be > 0)
+				b = lshift(b, be);
+			}
+		else
+			S = lshift(i2b(1), -be);
+		}
+
+	/* Scale by 10**-k and then correct k so that 1 <= b/S < 10. */
+	if (k > 0)
+		S = pow10mult(S, k);
+	else if (k < 0) {
+		b = pow10mult(b, -k);
+		if (mhi) {
+			mlo = pow10mult(mlo, -k);
+			mhi = pow10mult(mhi, -k);
+			}
+		}
+	for(;;) {
+		t = mul10(bdup(S));
+		j = cmp(b, t);
+		Bfree(t);
+		if (j < 0)
+			break;
+		S = mul10(S);
+		k++;
+		}
+	while(cmp(b, S) < 0) {
+		b = mul10(b);
+		if (mhi) {
+			mlo = mul10(mlo);
+			mhi = mul10(mhi);
+			}
+		k--;
+		}
+
+	nd = 0;
+	if (mode == 0) {
+		/* If the high end of the interval reaches 10**(k+1), the
+		 * first digit is a 1 one place further left.
+		 */
+		t = sum(b, mhi);
+		u = mul10(bdup(S));
+		j = cmp(t, u);
+		Bfree(t);
+		Bfree(u);
+		if (j > 0 || (j == 0 && even)) {
+			S = mul10(S);
+			k++;
+			}
+		for(;;) {
+			dig = qdigit(b, S);
+			j = cmp(b, mlo);
+			t = sum(b, mhi);
+			j1 = cmp(t, S);
+			Bfree(t);
+			tc1 = j < 0 || (j == 0 && even);
+			tc2 = j1 > 0 || (j1 == 0 && even);
+			if (tc1 && tc2) {
+				b = lshift(b, 1);
+				j = cmp(b, S);
+				if (j > 0 || (j == 0 && dig & 1))
+					dig++;
+				}
+			else if (tc2)
+				dig++;
+			buf[nd++] = '0' + dig;
+			if (tc1 || tc2)
+				break;
+			b = mul10(b);
+			mlo = mul10(mlo);
+			mhi = mul10(mhi);
+			}
+		}
+	else {
+		if (ndigits < 1)
+			ndigits = 1;
+		for(;;) {
+			dig = qdigit(b, S);
+			buf[nd++] = '0' + dig;
+			if (nd == ndigits || iszero(b))
+				break;
+			b = mul10(b);
+			}
+		up = 0;
+		if (!iszero(b))
+			switch(fpi->rounding) {
+			  case FPI_Round_near:
+				b = lshift(b, 1);
+				j = cmp(b, S);
+				up = j > 0 || (j == 0 && dig & 1);
+				break;
+			  case FPI_Round_up:
+				up = !sign;
+				break;
+			  case FPI_Round_down:
+				up = sign;
+			  }
+		if (up) {
+			while(nd > 0 && buf[nd - 1] == '9')
+				nd--;
+			if (nd == 0) {
+				buf[nd++] = '1';
+				k++;
+				}
+			else
+				buf[nd - 1]++;
+			}
+		}
+	while(nd > 1 && buf[nd - 1] == '0')
+		nd--;
+	buf[nd] = 0;
+	*decpt = k + 1;
+	Bfree(b);
+	Bfree(S);
+	if (mhi) {
+		Bfree(mlo);
+		Bfree(mhi);
+		}
+	return nd;
+	}
@@ -0,0 +1,62 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _STRNTO_H_
+#define _STRNTO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Length-bounded forms of strtod(3), strtof(3), strtoul(3), strtoumax(3)
+ * and strtoimax(3).  They convert a number from the first len bytes of
+ * nptr and never read nptr[len] or beyond, so nptr need not be
+ * NUL-terminated (e.g. a field of a memory-mapped file).  In every other
+ * respect, including errno and *endptr, they behave like the standard
+ * functions applied to a NUL-terminated copy of those len bytes.
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+double		strntod(const char *, size_t, char **);
+float		strntof(const char *, size_t, char **);
+unsigned long	strntoul(const char * __restrict, size_t, char ** __restrict,
+		    int);
+uintmax_t	strntoumax(const char * __restrict, size_t,
+		    char ** __restrict, int);
+intmax_t	strntoimax(const char * __restrict, size_t,
+		    char ** __restrict, int);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_STRNTO_H_ */
@@ -0,0 +1,344 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Digit generation and layout for printf's %e, %E, %g and %G.  Doubles
+ * get their digits from Ryu (ryu.c) and fall back to the exact Bigint
+ * engine (xdtoa.c) only when Ryu's shortest digits cannot be rounded to
+ * the requested precision without looking at the exact value; long
+ * doubles wider than a double always use the exact engine.
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "fpmath.h"
+#include "gdtoaimp.h"
+
+/*
+ * Significant digits in the exact decimal expansion of the longest
+ * value of a binary format, plus slack for the terminating NUL: m *
+ * 2**-n with m < 2**p has at most p*log10(2) + n*log10(5) + 1 of them.
+ */
+#define	XDIGITS(p, minexp)						\
+	((p) * 30103 / 100000 + ((p) - (minexp)) * 69898 / 100000 + 4)
+
+struct obuf {
+	char	*p;
+	size_t	room;
+	int	len;
+};
+
+static void
+oput(struct obuf *o, int c, int n)
+{
+
+	for (; n > 0; n--, o->len++)
+		if (o->room > 1) {
+			*o->p++ = c;
+			o->room--;
+		}
+}
+
+static void
+ostr(struct obuf *o, const char *s, int n)
+{
+
+	for (; n > 0; n--, o->len++, s++)
+		if (o->room > 1) {
+			*o->p++ = *s;
+			o->room--;
+		}
+}
+
+static int
+oend(struct obuf *o)
+{
+
+	if (o->room > 0)
+		*o->p = '\0';
+	return (o->len);
+}
+
+static int
+special(char *buf, size_t bufsize, int sign, int nan, int conv)
+{
+	struct obuf o = { buf, bufsize, 0 };
+	int upper;
+
+	upper = conv == 'E' || conv == 'G';
+	if (nan)
+		ostr(&o, upper ? "NAN" : "nan", 3);
+	else {
+		if (sign)
+			oput(&o, '-', 1);
+		ostr(&o, upper ? "INF" : "inf", 3);
+	}
+	return (oend(&o));
+}
+
+/*
+ * Lay out the nd digits at s, worth 0.s * 10**decpt, the way printf
+ * would for conv and prec.  A negative prec means the digits are the
+ * shortest round-trip ones; %g then switches to exponential notation
+ * from 10**pmax on.
+ */
+static int
+layout(char *buf, size_t bufsize, int sign, const char *s, int nd, int decpt,
+    int conv, int prec, int pmax, int alt)
+{
+	struct obuf o = { buf, bufsize, 0 };
+	char ebuf[8];
+	int estyle, fd, i, p, x;
+
+	x = decpt - 1;
+	if (conv == 'e' || conv == 'E') {
+		estyle = 1;
+		fd = prec < 0 ? nd - 1 : prec;
+	} else {
+		p = prec < 0 ? pmax : prec == 0 ? 1 : prec;
+		estyle = x < -4 || x >= p;
+		if (prec >= 0 && alt)
+			fd = estyle ? p - 1 : p - 1 - x;
+		else
+			fd = estyle ? nd - 1 : nd - 1 - x;
+		if (fd < 0)
+			fd = 0;
+		conv = conv == 'g' ? 'e' : 'E';
+	}
+	if (sign)
+		oput(&o, '-', 1);
+	if (estyle) {
+		oput(&o, s[0], 1);
+		if (fd > 0 || alt)
+			oput(&o, '.', 1);
+		i = nd - 1 < fd ? nd - 1 : fd;
+		ostr(&o, s + 1, i);
+		oput(&o, '0', fd - i);
+		oput(&o, conv, 1);
+		oput(&o, x < 0 ? '-' : '+', 1);
+		if (x < 0)
+			x = -x;
+		i = sizeof(ebuf);
+		do {
+			ebuf[--i] = '0' + x % 10;
+			x /= 10;
+		} while (x != 0 || i > (int)sizeof(ebuf) - 2);
+		ostr(&o, ebuf + i, sizeof(ebuf) - i);
+	} else {
+		if (decpt <= 0)
+			oput(&o, '0', 1);
+		else {
+			i = nd < decpt ? nd : decpt;
+			ostr(&o, s, i);
+			oput(&o, '0', decpt - i);
+		}
+		if (fd > 0 || alt)
+			oput(&o, '.', 1);
+		if (decpt < 0) {
+			i = -decpt < fd ? -decpt : fd;
+			oput(&o, '0', i);
+			fd -= i;
+			decpt = 0;
+		}
+		if (nd > decpt) {
+			i = nd - decpt < fd ? nd - decpt : fd;
+			ostr(&o, s + decpt, i);
+			fd -= i;
+		}
+		oput(&o, '0', fd);
+	}
+	return (oend(&o));
+}
+
+/*
+ * Number of significant digits printf needs for conv and prec, or -1
+ * for the shortest round-trip digits.
+ */
+static int
+ndigits(int conv, int prec)
+{
+
+	if (prec < 0)
+		return (-1);
+	if (conv == 'e' || conv == 'E')
+		return (prec + 1);
+	return (prec == 0 ? 1 : prec);
+}
+
+/*
+ * Round the digits at s to the first n of them, half up; the caller has
+ * ruled out an exact tie.  Returns the new digit count.
+ */
+static int
+rndigits(char *s, int n, int *decpt)
+{
+
+	if (s[n] >= '5') {
+		while (n > 0 && s[n - 1] == '9')
+			n--;
+		if (n == 0) {
+			s[n++] = '1';
+			++*decpt;
+		} else
+			s[n - 1]++;
+	} else
+		while (n > 1 && s[n - 1] == '0')
+			n--;
+	s[n] = '\0';
+	return (n);
+}
+
+/*
+ * Format d as printf's %<conv> would with precision prec, or with the
+ * shortest digits that read back as d if prec is negative; conv is one
+ * of e, E, g and G and alt is the # flag.  Like snprintf, at most
+ * bufsize - 1 characters and a NUL go to buf, and the length of the
+ * whole result is returned.
+ */
+int
+__g_efmt(char *buf, size_t bufsize, double d, int conv, int prec, int alt)
+{
+	static FPI fpi0 = { DBL_MANT_DIG, DBL_MIN_EXP - DBL_MANT_DIG,
+	    DBL_MAX_EXP - DBL_MANT_DIG, FPI_Round_near, 0 };
+	char s[XDIGITS(DBL_MANT_DIG, DBL_MIN_EXP)];
+	ULong bits[2];
+	U u;
+	int be, decpt, ex, n, nd, sign;
+#include "gdtoa_fltrnds.h"
+
+	sign = signbit(d) != 0;
+	if (!isfinite(d))
+		return (special(buf, bufsize, sign, isnan(d), conv));
+	n = ndigits(conv, prec);
+	if (n < 0 || (Rounding == FPI_Round_near && n <= 17)) {
+		/*
+		 * Rounding Ryu's digits to n gives the same result as
+		 * rounding d itself, unless they end in a 5 just past the
+		 * cut.  Fewer digits than asked for are correct as they
+		 * stand for n <= 15, where any two n-digit decimals are
+		 * further apart than a normal double from its shortest form.
+		 */
+		nd = __d2s(d, s, &decpt);
+		if (n < 0 || (nd <= n && n <= 15 && fabs(d) >= DBL_MIN))
+			goto done;
+		if (nd > n && (nd > n + 1 || s[n] != '5')) {
+			nd = rndigits(s, n, &decpt);
+			goto done;
+		}
+	}
+	dval(&u) = d;
+	bits[0] = word1(&u);
+	bits[1] = word0(&u) & Frac_mask;
+	if ((ex = (word0(&u) & Exp_mask) >> Exp_shift) != 0) {
+		bits[1] |= Exp_msk1;
+		be = ex - Bias - P + 1;
+	} else
+		be = fpi0.emin;
+	if (n > (int)sizeof(s) - 1)
+		n = sizeof(s) - 1;
+	nd = xdtoa(fpi, be, bits, sign, 2, n, s, &decpt);
+ done:
+	return (layout(buf, bufsize, sign, s, nd, decpt, conv, prec,
+	    DBL_DECIMAL_DIG, alt));
+}
+
+#if LDBL_MANT_DIG != DBL_MANT_DIG
+#define	LDBL_FPI { LDBL_MANT_DIG, LDBL_MIN_EXP - LDBL_MANT_DIG,		\
+	LDBL_MAX_EXP - LDBL_MANT_DIG, FPI_Round_near, 0 }
+
+/*
+ * Split a finite ld into the significand and exponent xdtoa wants.
+ */
+static int
+ld2bits(long double ld, ULong *bits)
+{
+	union IEEEl2bits u;
+
+	u.e = ld;
+	LDBL_TO_ARRAY32(u, bits);
+	if (u.bits.exp == 0)
+		return (LDBL_MIN_EXP - LDBL_MANT_DIG);
+#ifdef LDBL_IMPLICIT_NBIT
+	bits[LDBL_MANT_DIG / 32] |= 1U << ((LDBL_MANT_DIG - 1) % 32);
+#endif
+	return (u.bits.exp - (LDBL_MAX_EXP - 1) - (LDBL_MANT_DIG - 1));
+}
+#endif
+
+/*
+ * Shortest digits of a finite ld that read back as ld, as __d2s gives
+ * for a double.  buf needs room for LDBL_DECIMAL_DIG + 1 characters.
+ */
+int
+__ld2s(long double ld, char *buf, int *decpt)
+{
+#if LDBL_MANT_DIG == DBL_MANT_DIG
+	return (__d2s((double)ld, buf, decpt));
+#else
+	static FPI fpi0 = LDBL_FPI;
+	ULong bits[(LDBL_MANT_DIG + 31) / 32 + 1];
+	int be;
+
+	be = ld2bits(ld, bits);
+	return (xdtoa(&fpi0, be, bits, 0, 0, 0, buf, decpt));
+#endif
+}
+
+/*
+ * __g_efmt for long doubles.
+ */
+int
+__g_Lefmt(char *buf, size_t bufsize, long double ld, int conv, int prec,
+    int alt)
+{
+#if LDBL_MANT_DIG == DBL_MANT_DIG
+	return (__g_efmt(buf, bufsize, (double)ld, conv, prec, alt));
+#else
+	static FPI fpi0 = LDBL_FPI;
+	char s[XDIGITS(LDBL_MANT_DIG, LDBL_MIN_EXP)];
+	ULong bits[(LDBL_MANT_DIG + 31) / 32 + 1];
+	int be, decpt, n, nd, sign;
+#include "gdtoa_fltrnds.h"
+
+	sign = signbit(ld) != 0;
+	if (!isfinite(ld))
+		return (special(buf, bufsize, sign, isnan(ld), conv));
+	be = ld2bits(ld, bits);
+	n = ndigits(conv, prec);
+	if (n > (int)sizeof(s) - 1)
+		n = sizeof(s) - 1;
+	nd = xdtoa(fpi, be, bits, sign, n < 0 ? 0 : 2, n, s, &decpt);
+	return (layout(buf, bufsize, sign, s, nd, decpt, conv, prec,
+	    LDBL_DECIMAL_DIG, alt));
+#endif
+}
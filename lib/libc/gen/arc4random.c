@@ -55,6 +55,7 @@
 #define ARC4RANDOM_FXRNG 0
 #endif
 #include "chacha_private.h"
+#include "chacha_simd.h"
 
 #define minimum(a, b) ((a) < (b) ? (a) : (b))
 
@@ -67,70 +68,79 @@
 #define KEYSZ	32
 #define IVSZ	8
 #define BLOCKSZ	64
-#define RSBUFSZ	(16*BLOCKSZ)
+#define RSBUFSZ	(64*BLOCKSZ)
 
 #define REKEY_BASE	(1024*1024) /* NB. should be a power of 2 */
 
-/* Marked INHERIT_ZERO, so zero'd out in fork children. */
-static struct _rs {
+/*
+ * Zeroed in fork children, which makes them rekey before their next
+ * output: by the kernel where _rs_allocate() got MADV_WIPEONFORK, and
+ * otherwise by _rs_forkdetect() once it sees a new pid or fork count.
+ */
+struct _rs {
 	size_t		rs_have;	/* valid bytes at end of rs_buf */
 	size_t		rs_count;	/* bytes till reseed */
-} *rs;
+};
 
-/* Maybe be preserved in fork children, if _rs_allocate() decides. */
-static struct _rsx {
+/* Wiped in fork children along with _rs only under MADV_WIPEONFORK. */
+struct _rsx {
 	chacha_ctx	rs_chacha;	/* chacha context for random keystream */
 	u_char		rs_buf[RSBUFSZ];	/* keystream blocks */
 #ifdef __FreeBSD__
 	uint32_t	rs_seed_generation;	/* 32-bit userspace RNG version */
 #endif
-} *rsx;
+};
 
-static inline int _rs_allocate(struct _rs **, struct _rsx **);
-static inline void _rs_forkdetect(void);
+/*
+ * Each thread has a generator of its own, keyed separately from the
+ * kernel the first time the thread asks for random bytes, so that threads
+ * never wait for one another.  _rs_get() finds the calling thread's one.
+ * Where the kernel can wipe it in fork children, a wiped generator simply
+ * starts over; otherwise rs_checkpid is set and _rs_forkdetect() watches
+ * for forks itself.
+ */
+struct _rsthr {
+	struct _rs	rs;
+	struct _rsx	rsx;
+	int		rs_keyed;	/* rs_chacha has been keyed */
+	int		rs_checkpid;	/* not wiped on fork */
+	pid_t		rs_pid;		/* for _rs_forkdetect() */
+	unsigned int	rs_forkgen;
+};
+
+static inline int _rs_allocate(struct _rsthr **);
+static inline void _rs_forkdetect(struct _rsthr *);
 #include "arc4random.h"
 
-static inline void _rs_rekey(u_char *dat, size_t datlen);
+static inline void _rs_rekey(struct _rsthr *, u_char *dat, size_t datlen);
 
 static inline void
-_rs_init(u_char *buf, size_t n)
+_rs_init(struct _rsthr *t, u_char *buf, size_t n)
 {
 	if (n < KEYSZ + IVSZ)
 		return;
 
-	if (rs == NULL) {
-		if (_rs_allocate(&rs, &rsx) == -1)
-			_exit(1);
-	}
-
-	chacha_keysetup(&rsx->rs_chacha, buf, KEYSZ * 8);
-	chacha_ivsetup(&rsx->rs_chacha, buf + KEYSZ);
+	chacha_keysetup(&t->rsx.rs_chacha, buf, KEYSZ * 8);
+	chacha_ivsetup(&t->rsx.rs_chacha, buf + KEYSZ);
+	t->rs_keyed = 1;
 }
 
 static void
-_rs_stir(void)
+_rs_stir(struct _rsthr *t)
 {
+	struct _rs *rs = &t->rs;
+	struct _rsx *rsx = &t->rsx;
 	u_char rnd[KEYSZ + IVSZ];
 	uint32_t rekey_fuzz = 0;
 
 #if defined(__FreeBSD__)
-	bool need_init;
-
-	/*
-	 * De-couple allocation (which locates the vdso_fxrngp pointer in
-	 * auxinfo) from initialization.  This allows us to read the root seed
-	 * version before we fetch system entropy, maintaining the invariant
-	 * that the PRF was seeded with entropy from rs_seed_generation or a
-	 * later generation.  But never seeded from an earlier generation.
-	 * This invariant prevents us from missing a root reseed event.
-	 */
-	need_init = false;
-	if (rs == NULL) {
-		if (_rs_allocate(&rs, &rsx) == -1)
-			abort();
-		need_init = true;
-	}
 	/*
+	 * Read the root seed version before we fetch system entropy,
+	 * maintaining the invariant that the PRF was seeded with entropy from
+	 * rs_seed_generation or a later generation.  But never seeded from an
+	 * earlier generation.  This invariant prevents us from missing a root
+	 * reseed event.
+	 *
 	 * Transition period: new userspace on old kernel.  This should become
 	 * a hard error at some point, if the scheme is adopted.
 	 */
@@ -142,16 +152,10 @@ _rs_stir(void)
 	if (getentropy(rnd, sizeof rnd) == -1)
 		_getentropy_fail();
 
-#if !defined(__FreeBSD__)
-	if (!rs)
-		_rs_init(rnd, sizeof(rnd));
-#else /* __FreeBSD__ */
-	assert(rs != NULL);
-	if (need_init)
-		_rs_init(rnd, sizeof(rnd));
-#endif
+	if (!t->rs_keyed)
+		_rs_init(t, rnd, sizeof(rnd));
 	else
-		_rs_rekey(rnd, sizeof(rnd));
+		_rs_rekey(t, rnd, sizeof(rnd));
 	explicit_bzero(rnd, sizeof(rnd));	/* discard source seed */
 
 	/* invalidate rs_buf */
@@ -165,11 +169,13 @@ _rs_stir(void)
 }
 
 static inline void
-_rs_stir_if_needed(size_t len)
+_rs_stir_if_needed(struct _rsthr *t, size_t len)
 {
-	_rs_forkdetect();
-	if (!rs || rs->rs_count <= len)
-		_rs_stir();
+	struct _rs *rs = &t->rs;
+
+	_rs_forkdetect(t);
+	if (rs->rs_count <= len)
+		_rs_stir(t);
 	if (rs->rs_count <= len)
 		rs->rs_count = 0;
 	else
@@ -177,14 +183,16 @@ _rs_stir_if_needed(size_t len)
 }
 
 static inline void
-_rs_rekey(u_char *dat, size_t datlen)
+_rs_rekey(struct _rsthr *t, u_char *dat, size_t datlen)
 {
+	struct _rsx *rsx = &t->rsx;
+
 #ifndef KEYSTREAM_ONLY
 	memset(rsx->rs_buf, 0, sizeof(rsx->rs_buf));
 #endif
 	/* fill rs_buf with the keystream */
-	chacha_encrypt_bytes(&rsx->rs_chacha, rsx->rs_buf,
-	    rsx->rs_buf, sizeof(rsx->rs_buf));
+	chacha_keystream(&rsx->rs_chacha, rsx->rs_buf,
+	    sizeof(rsx->rs_buf) / BLOCKSZ);
 	/* mix in optional user provided data */
 	if (dat) {
 		size_t i, m;
@@ -194,19 +202,27 @@ _rs_rekey(u_char *dat, size_t datlen)
 			rsx->rs_buf[i] ^= dat[i];
 	}
 	/* immediately reinit for backtracking resistance */
-	_rs_init(rsx->rs_buf, KEYSZ + IVSZ);
+	_rs_init(t, rsx->rs_buf, KEYSZ + IVSZ);
 	memset(rsx->rs_buf, 0, KEYSZ + IVSZ);
-	rs->rs_have = sizeof(rsx->rs_buf) - KEYSZ - IVSZ;
+	t->rs.rs_have = sizeof(rsx->rs_buf) - KEYSZ - IVSZ;
 }
 
+/*
+ * Once rs_buf is used up, requests of at least RSBUFSZ bytes have whole
+ * blocks of keystream written straight into the caller's buffer instead
+ * of going through rs_buf a piece at a time.  rs_have is still 0 then, so
+ * the key that produced them is replaced before returning, as usual.
+ */
 static inline void
-_rs_random_buf(void *_buf, size_t n)
+_rs_random_buf(struct _rsthr *t, void *_buf, size_t n)
 {
+	struct _rs *rs = &t->rs;
+	struct _rsx *rsx = &t->rsx;
 	u_char *buf = (u_char *)_buf;
 	u_char *keystream;
 	size_t m;
 
-	_rs_stir_if_needed(n);
+	_rs_stir_if_needed(t, n);
 	while (n > 0) {
 		if (rs->rs_have > 0) {
 			m = minimum(n, rs->rs_have);
@@ -218,19 +234,27 @@ _rs_random_buf(void *_buf, size_t n)
 			n -= m;
 			rs->rs_have -= m;
 		}
+		if (rs->rs_have == 0 && n >= RSBUFSZ) {
+			m = n - n % BLOCKSZ;
+			chacha_keystream(&rsx->rs_chacha, buf, m / BLOCKSZ);
+			buf += m;
+			n -= m;
+		}
 		if (rs->rs_have == 0)
-			_rs_rekey(NULL, 0);
+			_rs_rekey(t, NULL, 0);
 	}
 }
 
 static inline void
-_rs_random_u32(uint32_t *val)
+_rs_random_u32(struct _rsthr *t, uint32_t *val)
 {
+	struct _rs *rs = &t->rs;
+	struct _rsx *rsx = &t->rsx;
 	u_char *keystream;
 
-	_rs_stir_if_needed(sizeof(*val));
+	_rs_stir_if_needed(t, sizeof(*val));
 	if (rs->rs_have < sizeof(*val))
-		_rs_rekey(NULL, 0);
+		_rs_rekey(t, NULL, 0);
 	keystream = rsx->rs_buf + sizeof(rsx->rs_buf) - rs->rs_have;
 	memcpy(val, keystream, sizeof(*val));
 	memset(keystream, 0, sizeof(*val));
@@ -240,18 +264,25 @@ _rs_random_u32(uint32_t *val)
 uint32_t
 arc4random(void)
 {
+	struct _rsthr *t;
 	uint32_t val;
+	int shared;
 
-	_ARC4_LOCK();
-	_rs_random_u32(&val);
-	_ARC4_UNLOCK();
+	t = _rs_get(&shared);
+	_rs_random_u32(t, &val);
+	if (shared)
+		_ARC4_UNLOCK();
 	return val;
 }
 
 void
 arc4random_buf(void *buf, size_t n)
 {
-	_ARC4_LOCK();
-	_rs_random_buf(buf, n);
-	_ARC4_UNLOCK();
+	struct _rsthr *t;
+	int shared;
+
+	t = _rs_get(&shared);
+	_rs_random_buf(t, buf, n);
+	if (shared)
+		_ARC4_UNLOCK();
 }
@@ -48,43 +48,90 @@ _getentropy_fail(void)
 	raise(SIGKILL);
 }
 
-static volatile sig_atomic_t _rs_forked;
+/* Bumped in fork children; see _rs_forkdetect(). */
+static volatile sig_atomic_t _rs_forkgen;
 
 static inline void
 _rs_forkhandler(void)
 {
-	_rs_forked = 1;
+	_rs_forkgen++;
 }
 
 static inline void
-_rs_forkdetect(void)
+_rs_forkdetect(struct _rsthr *t)
 {
-	static pid_t _rs_pid = 0;
-	pid_t pid = getpid();
-
-	if (_rs_pid == 0 || _rs_pid != pid || _rs_forked) {
-		_rs_pid = pid;
-		_rs_forked = 0;
-		if (rs)
-			memset(rs, 0, sizeof(*rs));
+	pid_t pid;
+
+	/* A fork child finds a wiped generator all zeroes and rekeys it. */
+	if (!t->rs_checkpid)
+		return;
+	pid = getpid();
+	if (t->rs_pid != pid || t->rs_forkgen != (unsigned int)_rs_forkgen) {
+		t->rs_pid = pid;
+		t->rs_forkgen = _rs_forkgen;
+		memset(&t->rs, 0, sizeof(t->rs));
 	}
 }
 
 static inline int
-_rs_allocate(struct _rs **rsp, struct _rsx **rsxp)
+_rs_allocate(struct _rsthr **tp)
 {
-	if ((*rsp = mmap(NULL, sizeof(**rsp), PROT_READ|PROT_WRITE,
+	if ((*tp = mmap(NULL, sizeof(**tp), PROT_READ|PROT_WRITE,
 	    MAP_ANON|MAP_PRIVATE, -1, 0)) == MAP_FAILED)
 		return (-1);
+#ifdef MADV_WIPEONFORK
+	if (madvise(*tp, sizeof(**tp), MADV_WIPEONFORK) == 0)
+		return (0);
+#endif
+	(*tp)->rs_checkpid = 1;
+	return (0);
+}
 
-	if ((*rsxp = mmap(NULL, sizeof(**rsxp), PROT_READ|PROT_WRITE,
-	    MAP_ANON|MAP_PRIVATE, -1, 0)) == MAP_FAILED) {
-		munmap(*rsp, sizeof(**rsp));
-		*rsp = NULL;
-		return (-1);
-	}
+static pthread_once_t _rs_once = PTHREAD_ONCE_INIT;
+static pthread_key_t _rs_key;
+static int _rs_keyok;
+static struct _rsthr *_rs_shared;
 
+static void
+_rs_thread_exit(void *t)
+{
+	explicit_bzero(t, sizeof(struct _rsthr));
+	munmap(t, sizeof(struct _rsthr));
+}
+
+static void
+_rs_once_init(void)
+{
+	_rs_keyok = pthread_key_create(&_rs_key, _rs_thread_exit) == 0;
 	_ARC4_ATFORK(_rs_forkhandler);
-	return (0);
 }
-#endif
\ No newline at end of file
+
+/*
+ * Return the calling thread's generator, allocating it on first use.
+ * If there is no thread-specific data to be had, fall back to a single
+ * generator shared under arc4random_mtx; *shared is then set and the
+ * caller must _ARC4_UNLOCK() when done with it.
+ */
+static inline struct _rsthr *
+_rs_get(int *shared)
+{
+	struct _rsthr *t;
+
+	pthread_once(&_rs_once, _rs_once_init);
+	*shared = 0;
+	if (_rs_keyok) {
+		if ((t = pthread_getspecific(_rs_key)) != NULL)
+			return (t);
+		if (_rs_allocate(&t) == -1)
+			abort();
+		if (pthread_setspecific(_rs_key, t) == 0)
+			return (t);
+		munmap(t, sizeof(*t));
+	}
+	*shared = 1;
+	_ARC4_LOCK();
+	if (_rs_shared == NULL && _rs_allocate(&_rs_shared) == -1)
+		abort();
+	return (_rs_shared);
+}
+#endif
@@ -18,39 +18,130 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include <arc4random_uniform.h>
 
 /*
  * Calculate a uniformly distributed random number less than upper_bound
  * avoiding "modulo bias".
  *
- * Uniformity is achieved by generating new random numbers until the one
- * returned is outside the range [0, 2**32 % upper_bound).  This
- * guarantees the selected random number will be inside
- * [2**32 % upper_bound, 2**32) which maps back to [0, upper_bound)
- * after reduction modulo upper_bound.
+ * The 32-bit random number r is scaled to r * upper_bound / 2**32 with a
+ * single multiplication (D. Lemire, "Fast Random Integer Generation in an
+ * Interval", 2019).  Every result stands for either floor(2**32 /
+ * upper_bound) or one more of the possible r, told apart by the low half
+ * of the product; uniformity is achieved by rejecting the r whose low half
+ * is below 2**32 % upper_bound, which leaves exactly floor(2**32 /
+ * upper_bound) of them for every result.  The low half can only be that
+ * small if it is below upper_bound, so the division computing the
+ * threshold is rarely needed.
  */
 uint32_t
 arc4random_uniform(uint32_t upper_bound)
 {
-	uint32_t r, min;
+	uint64_t m;
+	uint32_t min;
 
 	if (upper_bound < 2)
 		return 0;
 
-	/* 2**32 % x == (2**32 - x) % x */
-	min = -upper_bound % upper_bound;
+	m = (uint64_t)arc4random() * upper_bound;
+	if ((uint32_t)m < upper_bound) {
+		/* 2**32 % x == (2**32 - x) % x */
+		min = -upper_bound % upper_bound;
 
-	/*
-	 * This could theoretically loop forever but each retry has
-	 * p > 0.5 (worst case, usually far better) of selecting a
-	 * number inside the range we need, so it should rarely need
-	 * to re-roll.
-	 */
-	for (;;) {
-		r = arc4random();
-		if (r >= min)
-			break;
+		/*
+		 * This could theoretically loop forever but each retry has
+		 * p > 0.5 (worst case, usually far better) of selecting a
+		 * number inside the range we need, so it should rarely need
+		 * to re-roll.
+		 */
+		while ((uint32_t)m < min)
+			m = (uint64_t)arc4random() * upper_bound;
 	}
 
-	return r % upper_bound;
+	return m >> 32;
+}
+
+/*
+ * Full 128-bit product of a and b, returning the high half and storing
+ * the low half in *lo.
+ */
+static inline uint64_t
+mul64(uint64_t a, uint64_t b, uint64_t *lo)
+{
+#ifdef __SIZEOF_INT128__
+	__uint128_t m = (__uint128_t)a * b;
+
+	*lo = (uint64_t)m;
+	return m >> 64;
+#else
+	uint64_t al = (uint32_t)a, ah = a >> 32;
+	uint64_t bl = (uint32_t)b, bh = b >> 32;
+	uint64_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+	uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+
+	*lo = (mid << 32) | (uint32_t)ll;
+	return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+static inline uint64_t
+arc4random64(void)
+{
+	return (uint64_t)arc4random() << 32 | arc4random();
+}
+
+/*
+ * As arc4random_uniform(), for a 64-bit upper_bound.
+ */
+uint64_t
+arc4random_uniform64(uint64_t upper_bound)
+{
+	uint64_t hi, lo, min;
+
+	if (upper_bound < 2)
+		return 0;
+
+	hi = mul64(arc4random64(), upper_bound, &lo);
+	if (lo < upper_bound) {
+		min = -upper_bound % upper_bound;
+		while (lo < min)
+			hi = mul64(arc4random64(), upper_bound, &lo);
+	}
+
+	return hi;
+}
+
+/*
+ * Fill buf with n independent, uniformly distributed random numbers less
+ * than upper_bound.  The random words for the whole array come from a
+ * single arc4random_buf() call and are scaled in place, and the rejection
+ * threshold is computed once rather than per element, so filling large
+ * arrays runs at the speed of the keystream.  An n too large for the
+ * byte count to fit a size_t cannot describe a real array, and aborts
+ * rather than leave buf unfilled.
+ */
+void
+arc4random_uniform_buf(uint32_t upper_bound, uint32_t *buf, size_t n)
+{
+	uint64_t m;
+	uint32_t min;
+	size_t i;
+
+	if (n > SIZE_MAX / sizeof(*buf))
+		abort();
+	if (upper_bound < 2) {
+		memset(buf, 0, n * sizeof(*buf));
+		return;
+	}
+
+	arc4random_buf(buf, n * sizeof(*buf));
+	min = -upper_bound % upper_bound;
+	for (i = 0; i < n; i++) {
+		m = (uint64_t)buf[i] * upper_bound;
+		while ((uint32_t)m < min)
+			m = (uint64_t)arc4random() * upper_bound;
+		buf[i] = m >> 32;
+	}
 }
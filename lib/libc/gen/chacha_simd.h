@@ -0,0 +1,168 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * ChaCha20 keystream for arc4random, several blocks at a time.
+ *
+ * chacha_encrypt_bytes() in chacha_private.h computes one block at a
+ * time in scalar registers.  chacha_keystream() instead keeps word i of
+ * W consecutive blocks in lane 0..W-1 of one vector, so each quarter
+ * round works on W blocks at once, and then transposes the result into
+ * W ordinary 64-byte blocks.  The code is written once with the
+ * compiler's generic vector types, which become SSE2 or AVX2 on x86 and
+ * NEON on ARM; the AVX2 variant is picked at run time when the CPU and
+ * OS support it.  The output is bit for bit what chacha_encrypt_bytes()
+ * would produce for the same state, and the block counter advances the
+ * same way.
+ */
+
+#ifndef CHACHA_SIMD_H
+#define CHACHA_SIMD_H
+
+#include <endian.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#include "sys/sys/hw_probe.h"
+#define CHACHA_SIMD	1
+#define CHACHA_AVX2	1
+#elif defined(__ARM_NEON) && BYTE_ORDER == LITTLE_ENDIAN
+#define CHACHA_SIMD	1
+#endif
+
+#ifdef CHACHA_SIMD
+typedef u32 chacha_v4 __attribute__((vector_size(16)));
+#ifdef CHACHA_AVX2
+typedef u32 chacha_v8 __attribute__((vector_size(32)));
+#endif
+
+#define CHACHA_VROTL(v, n)	(((v) << (n)) | ((v) >> (32 - (n))))
+#define CHACHA_VQR(a, b, c, d) do {					\
+	a += b; d ^= a; d = CHACHA_VROTL(d, 16);			\
+	c += d; b ^= c; b = CHACHA_VROTL(b, 12);			\
+	a += b; d ^= a; d = CHACHA_VROTL(d, 8);				\
+	c += d; b ^= c; b = CHACHA_VROTL(b, 7);				\
+} while (0)
+
+/*
+ * Define a function that writes W blocks of keystream per iteration for
+ * as long as at least W are wanted, and returns how many it wrote.
+ */
+#define CHACHA_BLOCKS(name, vtype, W, attr)				\
+static attr size_t							\
+name(chacha_ctx *ctx, u8 *c, size_t nblocks)				\
+{									\
+	vtype j[16], x[16], o[16], lane;				\
+	u32 t[W], lo, hi;						\
+	size_t done;							\
+	int i, b;							\
+									\
+	for (i = 0; i < W; i++)						\
+		t[i] = i;						\
+	memcpy(&lane, t, sizeof(lane));					\
+	for (i = 0; i < 16; i++)					\
+		j[i] = (vtype){ 0 } + ctx->input[i];			\
+	for (done = 0; nblocks - done >= W; done += W) {		\
+		lo = ctx->input[12] + (u32)done;			\
+		hi = ctx->input[13] + (lo < ctx->input[12]);		\
+		j[12] = lane + lo;					\
+		j[13] = ((vtype){ 0 } + hi) -				\
+		    (vtype)(j[12] < ((vtype){ 0 } + lo));		\
+		for (i = 0; i < 16; i++)				\
+			x[i] = j[i];					\
+		for (i = 20; i > 0; i -= 2) {				\
+			CHACHA_VQR(x[0], x[4], x[8], x[12]);		\
+			CHACHA_VQR(x[1], x[5], x[9], x[13]);		\
+			CHACHA_VQR(x[2], x[6], x[10], x[14]);		\
+			CHACHA_VQR(x[3], x[7], x[11], x[15]);		\
+			CHACHA_VQR(x[0], x[5], x[10], x[15]);		\
+			CHACHA_VQR(x[1], x[6], x[11], x[12]);		\
+			CHACHA_VQR(x[2], x[7], x[8], x[13]);		\
+			CHACHA_VQR(x[3], x[4], x[9], x[14]);		\
+		}							\
+		for (i = 0; i < 16; i++)				\
+			o[i] = x[i] + j[i];				\
+		for (b = 0; b < W; b++)					\
+			for (i = 0; i < 16; i++)			\
+				memcpy(c + 64 * (done + b) + 4 * i,	\
+				    (u32 *)&o[i] + b, 4);		\
+	}								\
+	return (done);							\
+}
+
+CHACHA_BLOCKS(chacha_blocks4, chacha_v4, 4, )
+#ifdef CHACHA_AVX2
+CHACHA_BLOCKS(chacha_blocks8, chacha_v8, 8, __attribute__((target("avx2"))))
+
+/* 1 if the CPU and OS support AVX2, else 0. */
+static int
+chacha_have_avx2(void)
+{
+
+	return (hw_x86_avx_level() >= HW_X86_AVX2);
+}
+#endif
+
+typedef size_t chacha_blocks_fn(chacha_ctx *, u8 *, size_t);
+
+/* The widest variant the CPU has, probed once. */
+static chacha_blocks_fn *
+chacha_select(void)
+{
+#ifdef CHACHA_AVX2
+	if (HW_PROBE_ONCE(chacha_have_avx2))
+		return (chacha_blocks8);
+#endif
+	return (chacha_blocks4);
+}
+#endif /* CHACHA_SIMD */
+
+/*
+ * Write nblocks 64-byte blocks of keystream to c and advance the block
+ * counter past them.
+ */
+static void
+chacha_keystream(chacha_ctx *x, u8 *c, size_t nblocks)
+{
+	size_t done = 0;
+	u32 lo;
+#ifdef CHACHA_SIMD
+	done = chacha_select()(x, c, nblocks);
+	if (done != 0) {
+		lo = x->input[12];
+		x->input[12] += (u32)done;
+		x->input[13] += x->input[12] < lo;
+	}
+#endif
+	if (done < nblocks)
+		chacha_encrypt_bytes(x, c + 64 * done, c + 64 * done,
+		    (u32)(64 * (nblocks - done)));
+}
+
+#endif /* CHACHA_SIMD_H */
@@ -0,0 +1,143 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _STRTO_DIGITS_H_
+#define _STRTO_DIGITS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Value of each character as a digit in bases up to 36, or 0xff if the
+ * character is not a digit in any base.  Shared by the strtoul family.
+ */
+static const unsigned char __strto_digit[256] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0, 1, 2, 3, 4, 5, 6, 7,                         /* '0' - '7' */
+    8, 9, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,       /* '8' - '9' */
+    0xff, 10, 11, 12, 13, 14, 15, 16,               /* 'A' - 'G' */
+    17, 18, 19, 20, 21, 22, 23, 24,                 /* 'H' - 'O' */
+    25, 26, 27, 28, 29, 30, 31, 32,                 /* 'P' - 'W' */
+    33, 34, 35, 0xff, 0xff, 0xff, 0xff, 0xff,       /* 'X' - 'Z' */
+    0xff, 10, 11, 12, 13, 14, 15, 16,               /* 'a' - 'g' */
+    17, 18, 19, 20, 21, 22, 23, 24,                 /* 'h' - 'o' */
+    25, 26, 27, 28, 29, 30, 31, 32,                 /* 'p' - 'w' */
+    33, 34, 35, 0xff, 0xff, 0xff, 0xff, 0xff,       /* 'x' - 'z' */
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+/*
+ * The strtoul family is implemented in terms of the length-bounded
+ * strntoul family, which never looks at nptr[len] or beyond; the
+ * NUL-terminated entry points pass a len of SIZE_MAX.  __STRTO_PEEK()
+ * fetches the byte at p of the string being converted, or NUL once p has
+ * run off its end, and expects nptr and len to be in scope.
+ */
+static inline char
+__strto_peek(const char *p, const char *nptr, size_t len)
+{
+    return ((size_t)(p - nptr) < len ? *p : '\0');
+}
+
+#define __STRTO_PEEK(p) __strto_peek((p), nptr, len)
+
+/*
+ * Accumulate the run of base-`base' digits among the n bytes starting at
+ * s, for base 10 or 16 only.  Returns a pointer to the first character
+ * that is not a digit and stores the value in *accp and the usual strtol
+ * `any' flag (0 for no digits, 1 for a value, -1 for a value greater than
+ * limit) in *anyp.
+ *
+ * While the accumulator is far enough below limit, four digits are folded
+ * in per iteration with no overflow test at all; the remaining digits go
+ * through __builtin_mul_overflow.  Each group is only looked at one byte
+ * at a time, so nothing past a terminating NUL is ever read.  Once the
+ * value has overflowed the remaining digits are still consumed so that
+ * the end pointer matches the generic loop.
+ */
+static inline const char *
+__strto_digits(const char *s, size_t n, unsigned base, uintmax_t limit,
+    uintmax_t *accp, int *anyp)
+{
+    const unsigned char *p = (const unsigned char *)s;
+    const unsigned base4 = base * base * base * base;
+    uintmax_t acc, safe;
+    unsigned d0, d1, d2, d3;
+    int any;
+
+    acc = 0;
+    any = 0;
+    safe = (limit - (base4 - 1)) / base4;
+    while (acc <= safe && n >= 4 &&
+        (d0 = __strto_digit[p[0]]) < base &&
+        (d1 = __strto_digit[p[1]]) < base &&
+        (d2 = __strto_digit[p[2]]) < base &&
+        (d3 = __strto_digit[p[3]]) < base) {
+        acc = acc * base4 + ((d0 * base + d1) * base + d2) * base + d3;
+        any = 1;
+        p += 4;
+        n -= 4;
+    }
+    for (; n > 0 && (d0 = __strto_digit[*p]) < base; p++, n--) {
+        if (any < 0 ||
+            __builtin_mul_overflow(acc, base, &acc) ||
+            __builtin_add_overflow(acc, d0, &acc) ||
+            acc > limit) {
+            any = -1;
+        } else {
+            any = 1;
+        }
+    }
+    *accp = acc;
+    *anyp = any;
+    return ((const char *)p);
+}
+
+#endif /* !_STRTO_DIGITS_H_ */
@@ -45,20 +45,24 @@ static char sccsid[] = "@(#)strtoul.c	8.1 (Berkeley) 6/4/93";
 #include <errno.h>
 #include <stdlib.h>
 // #include "xlocale_private.h"
+#include "strto_digits.h"
 
 /*
- * Convert a string to an unsigned long integer.
+ * Convert the first len bytes of a string to an unsigned long integer; nptr
+ * need not be NUL-terminated.
  *
  * Assumes that the upper and lower case
  * alphabets and digits are each contiguous.
  */
 unsigned long
-strtoul_l(const char * __restrict nptr, char ** __restrict endptr, int base)
+strntoul(const char * __restrict nptr, size_t len, char ** __restrict endptr,
+    int base)
 {
     const char *s;
     unsigned long acc;
     char c;
     unsigned long cutoff;
+    uintmax_t wacc;
     int neg, any, cutlim;
     // FIX_LOCALE(locale);
 
@@ -67,22 +71,20 @@ strtoul_l(const char * __restrict nptr, char ** __restrict endptr, int base)
      */
     s = nptr;
     do {
-        c = *s++;
+        c = __STRTO_PEEK(s++);
     } while (isspace((unsigned char)c));
     if (c == '-') {
         neg = 1;
-        c = *s++;
+        c = __STRTO_PEEK(s++);
     } else {
         neg = 0;
         if (c == '+') {
-            c = *s++;
+            c = __STRTO_PEEK(s++);
         }
     }
     if ((base == 0 || base == 16) &&
-        c == '0' && (*s == 'x' || *s == 'X') &&
-        ((s[1] >= '0' && s[1] <= '9') ||
-        (s[1] >= 'A' && s[1] <= 'F') ||
-        (s[1] >= 'a' && s[1] <= 'f'))) {
+        c == '0' && (__STRTO_PEEK(s) == 'x' || __STRTO_PEEK(s) == 'X') &&
+        __strto_digit[(unsigned char)__STRTO_PEEK(s + 1)] < 16) {
         c = s[1];
         s += 2;
         base = 16;
@@ -95,9 +97,20 @@ strtoul_l(const char * __restrict nptr, char ** __restrict endptr, int base)
         goto noconv;
     }
 
+    /*
+     * Decimal and hexadecimal input is by far the most common; hand it to
+     * the table-driven accumulator, which returns the first non-digit.
+     */
+    if (base == 10 || base == 16) {
+        s = __strto_digits(s - 1, len - (s - 1 - nptr), base, ULONG_MAX,
+            &wacc, &any) + 1;
+        acc = wacc;
+        goto done;
+    }
+
     cutoff = ULONG_MAX / base;
     cutlim = ULONG_MAX % base;
-    for (;; c = *s++) {
+    for (;; c = __STRTO_PEEK(s++)) {
         if (c >= '0' && c <= '9') {
             c -= '0';
         } else if (c >= 'A' && c <= 'Z') {
@@ -118,6 +131,7 @@ strtoul_l(const char * __restrict nptr, char ** __restrict endptr, int base)
             acc += c;
         }
     }
+done:
     if (any < 0) {
         acc = ULONG_MAX;
         errno = ERANGE;
@@ -133,6 +147,11 @@ noconv:
     return (acc);
 }
 unsigned long
+strtoul_l(const char * __restrict nptr, char ** __restrict endptr, int base)
+{
+    return strntoul(nptr, SIZE_MAX, endptr, base);
+}
+unsigned long
 strtoul(const char * __restrict nptr, char ** __restrict endptr, int base)
 {
     return strtoul_l(nptr, endptr, base);
@@ -45,20 +45,24 @@ static char sccsid[] = "from @(#)strtoul.c	8.1 (Berkeley) 6/4/93";
 #include <stdlib.h>
 #include <inttypes.h>
 // #include "xlocale_private.h"
+#include "strto_digits.h"
 
 /*
- * Convert a string to a uintmax_t integer.
+ * Convert the first len bytes of a string to a uintmax_t integer; nptr
+ * need not be NUL-terminated.
  *
  * Assumes that the upper and lower case
  * alphabets and digits are each contiguous.
  */
 uintmax_t
-strtoumax_l(const char * __restrict nptr, char ** __restrict endptr, int base)
+strntoumax(const char * __restrict nptr, size_t len, char ** __restrict endptr,
+    int base)
 {
     const char *s;
     uintmax_t acc;
     char c;
     uintmax_t cutoff;
+    uintmax_t wacc;
     int neg, any, cutlim;
     // FIX_LOCALE(locale);
 
@@ -67,22 +71,20 @@ strtoumax_l(const char * __restrict nptr, char ** __restrict endptr, int base)
      */
     s = nptr;
     do {
-        c = *s++;
+        c = __STRTO_PEEK(s++);
     } while (isspace((unsigned char)c));
     if (c == '-') {
         neg = 1;
-        c = *s++;
+        c = __STRTO_PEEK(s++);
     } else {
         neg = 0;
         if (c == '+') {
-            c = *s++;
+            c = __STRTO_PEEK(s++);
         }
     }
     if ((base == 0 || base == 16) &&
-        c == '0' && (*s == 'x' || *s == 'X') &&
-        ((s[1] >= '0' && s[1] <= '9') ||
-        (s[1] >= 'A' && s[1] <= 'F') ||
-        (s[1] >= 'a' && s[1] <= 'f'))) {
+        c == '0' && (__STRTO_PEEK(s) == 'x' || __STRTO_PEEK(s) == 'X') &&
+        __strto_digit[(unsigned char)__STRTO_PEEK(s + 1)] < 16) {
         c = s[1];
         s += 2;
         base = 16;
@@ -95,9 +97,20 @@ strtoumax_l(const char * __restrict nptr, char ** __restrict endptr, int base)
         goto noconv;
     }
 
+    /*
+     * Decimal and hexadecimal input is by far the most common; hand it to
+     * the table-driven accumulator, which returns the first non-digit.
+     */
+    if (base == 10 || base == 16) {
+        s = __strto_digits(s - 1, len - (s - 1 - nptr), base, UINTMAX_MAX,
+            &wacc, &any) + 1;
+        acc = wacc;
+        goto done;
+    }
+
     cutoff = UINTMAX_MAX / base;
     cutlim = UINTMAX_MAX % base;
-    for (;; c = *s++) {
+    for (;; c = __STRTO_PEEK(s++)) {
         if (c >= '0' && c <= '9') {
             c -= '0';
         } else if (c >= 'A' && c <= 'Z') {
@@ -118,6 +131,7 @@ strtoumax_l(const char * __restrict nptr, char ** __restrict endptr, int base)
             acc += c;
         }
     }
+done:
     if (any < 0) {
         acc = UINTMAX_MAX;
         errno = ERANGE;
@@ -133,6 +147,11 @@ noconv:
     return (acc);
 }
 uintmax_t
+strtoumax_l(const char * __restrict nptr, char ** __restrict endptr, int base)
+{
+    return strntoumax(nptr, SIZE_MAX, endptr, base);
+}
+uintmax_t
 strtoumax(const char * __restrict nptr, char ** __restrict endptr, int base)
 {
     return strtoumax_l(nptr, endptr, base);
@@ -0,0 +1,366 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Throughput and contention benchmark for arc4random(3).  Each workload
+ * (arc4random, arc4random_uniform, arc4random_uniform_buf and
+ * arc4random_buf at sizes from 4 bytes to 1 MiB) is run by 1, 2, 4, ...
+ * up to the requested number of threads at once, and reported as ns per
+ * call in each thread, aggregate calls/s and bytes/s.  A fork storm then
+ * forks repeatedly while other threads keep calling arc4random(), checks
+ * that no two children and no parent saw the same first value, and
+ * reports forks/s.
+ *
+ * The "wait" column is the time each call spent off CPU, i.e. the wall
+ * clock time of the worker threads less their CPU time.  As long as
+ * there are no more threads than CPUs this is time spent asleep on
+ * arc4random's lock, so it should stay near zero with per-thread state
+ * and grow with the thread count if calls serialize.
+ *
+ * It links arc4random.c directly, so the library in the tree is measured
+ * rather than the host's.  From the top of the tree:
+ *
+ *	cc -O2 -D_GNU_SOURCE -o arc4random_bench \
+ *	    lib/libc/tests/gen/arc4random_bench.c lib/libc/gen/arc4random.c \
+ *	    lib/libc/gen/arc4random_uniform.c -Iinclude \
+ *	    -Icrypto/openssh/openbsd-compat -lpthread
+ *	./arc4random_bench [-d seconds] [-f forks] [-t threads] [calls | fork]
+ *
+ * To compare two revisions, build this file against each and run both.
+ */
+
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "arc4random_uniform.h"
+
+/* Not declared by every host's <stdlib.h>. */
+uint32_t	arc4random(void);
+void		arc4random_buf(void *, size_t);
+uint32_t	arc4random_uniform(uint32_t);
+
+#define MAXTHREADS  256
+#define MAXBUF      (1024 * 1024)
+#define UBUFN       1024        /* elements per arc4random_uniform_buf call */
+
+enum work {
+    W_U32,
+    W_UNIFORM,
+    W_UNIFORM_BUF,
+    W_BUF
+};
+
+struct worker {
+    pthread_t thr;
+    enum work work;
+    size_t size;
+    unsigned char *buf;
+    long calls;
+    double wall;
+    double cpu;
+};
+
+static double duration = 0.25;
+static pthread_barrier_t barrier;
+static volatile int stop;
+
+static double
+clock_sec(clockid_t id)
+{
+    struct timespec ts;
+
+    clock_gettime(id, &ts);
+    return (ts.tv_sec + ts.tv_nsec * 1e-9);
+}
+
+static void *
+worker_main(void *arg)
+{
+    struct worker *w = arg;
+    volatile uint32_t sink = 0;
+    uint32_t *ubuf = (uint32_t *)w->buf;
+    double w0, c0;
+    long calls = 0;
+    int batch, i;
+
+    /* Check the stop flag only every few calls for the small cases. */
+    batch = w->work == W_BUF && w->size >= 65536 ? 1 : 64;
+    pthread_barrier_wait(&barrier);
+    w0 = clock_sec(CLOCK_MONOTONIC);
+    c0 = clock_sec(CLOCK_THREAD_CPUTIME_ID);
+    while (!stop) {
+        for (i = 0; i < batch; i++) {
+            switch (w->work) {
+            case W_U32:
+                sink += arc4random();
+                break;
+            case W_UNIFORM:
+                sink += arc4random_uniform(1000003);
+                break;
+            case W_UNIFORM_BUF:
+                arc4random_uniform_buf(1000003, ubuf, UBUFN);
+                break;
+            case W_BUF:
+                arc4random_buf(w->buf, w->size);
+                break;
+            }
+        }
+        calls += i;
+    }
+    w->wall = clock_sec(CLOCK_MONOTONIC) - w0;
+    w->cpu = clock_sec(CLOCK_THREAD_CPUTIME_ID) - c0;
+    w->calls = calls;
+    return (NULL);
+}
+
+/*
+ * Run one workload in nthreads threads for the set duration and print a
+ * line for it.
+ */
+static void
+run(const char *name, enum work work, size_t size, int nthreads)
+{
+    struct worker w[MAXTHREADS];
+    double wall = 0, wait = 0, ns;
+    long calls = 0;
+    int i;
+
+    pthread_barrier_init(&barrier, NULL, nthreads + 1);
+    stop = 0;
+    for (i = 0; i < nthreads; i++) {
+        memset(&w[i], 0, sizeof(w[i]));
+        w[i].work = work;
+        w[i].size = size;
+        if ((w[i].buf = malloc(MAXBUF)) == NULL) {
+            perror("malloc");
+            exit(1);
+        }
+        if ((errno = pthread_create(&w[i].thr, NULL, worker_main,
+            &w[i])) != 0) {
+            perror("pthread_create");
+            exit(1);
+        }
+    }
+    pthread_barrier_wait(&barrier);
+    usleep((useconds_t)(duration * 1e6));
+    stop = 1;
+    for (i = 0; i < nthreads; i++) {
+        pthread_join(w[i].thr, NULL);
+        free(w[i].buf);
+        calls += w[i].calls;
+        wall += w[i].wall;
+        wait += w[i].wall > w[i].cpu ? w[i].wall - w[i].cpu : 0;
+    }
+    pthread_barrier_destroy(&barrier);
+
+    if (work == W_UNIFORM_BUF) {
+        size = UBUFN * sizeof(uint32_t);
+    } else if (work != W_BUF) {
+        size = sizeof(uint32_t);
+    }
+    ns = wall * 1e9 / calls;
+    printf("%-24s %3d thr %10.1f ns/call %9.3f Mcalls/s %9.1f MB/s "
+        "%8.1f ns wait\n", name, nthreads, ns,
+        calls / (wall / nthreads) / 1e6,
+        calls * (double)size / (wall / nthreads) / 1e6,
+        wait * 1e9 / calls);
+}
+
+static void
+bench_calls(int maxthreads)
+{
+    static const size_t sizes[] = {
+        4, 16, 64, 256, 1024, 4096, 16384, 65536, 262144, MAXBUF
+    };
+    char name[32];
+    size_t i;
+    int n;
+
+    for (n = 1;; n *= 2) {
+        if (n > maxthreads) {
+            n = maxthreads;
+        }
+        run("arc4random", W_U32, 0, n);
+        run("arc4random_uniform", W_UNIFORM, 0, n);
+        run("uniform_buf[1024]", W_UNIFORM_BUF, 0, n);
+        for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            snprintf(name, sizeof(name), "arc4random_buf(%zu)", sizes[i]);
+            run(name, W_BUF, sizes[i], n);
+        }
+        if (n == maxthreads) {
+            break;
+        }
+    }
+}
+
+static int
+cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+    return (x < y ? -1 : x > y);
+}
+
+/*
+ * Fork nforks children, one at a time, while nthreads other threads keep
+ * calling arc4random().  Each child sends back its first arc4random()
+ * value and the parent records its next one after every fork; any value
+ * seen twice means a child reused its parent's keystream.
+ */
+static int
+bench_fork(int nforks, int nthreads)
+{
+    struct worker w[MAXTHREADS];
+    uint32_t *seen;
+    double t0, t;
+    int fds[2], i, n, dups, status;
+    pid_t pid;
+
+    if ((seen = malloc(2 * nforks * sizeof(*seen))) == NULL) {
+        perror("malloc");
+        exit(1);
+    }
+    pthread_barrier_init(&barrier, NULL, nthreads + 1);
+    stop = 0;
+    for (i = 0; i < nthreads; i++) {
+        memset(&w[i], 0, sizeof(w[i]));
+        w[i].work = W_U32;
+        pthread_create(&w[i].thr, NULL, worker_main, &w[i]);
+    }
+    pthread_barrier_wait(&barrier);
+
+    n = 0;
+    t0 = clock_sec(CLOCK_MONOTONIC);
+    for (i = 0; i < nforks; i++) {
+        (void)arc4random();
+        if (pipe(fds) == -1 || (pid = fork()) == -1) {
+            perror("fork");
+            exit(1);
+        }
+        if (pid == 0) {
+            uint32_t v = arc4random();
+
+            (void)write(fds[1], &v, sizeof(v));
+            _exit(0);
+        }
+        close(fds[1]);
+        if (read(fds[0], &seen[n], sizeof(seen[n])) == sizeof(seen[n])) {
+            n++;
+        }
+        close(fds[0]);
+        waitpid(pid, &status, 0);
+        seen[n++] = arc4random();
+    }
+    t = clock_sec(CLOCK_MONOTONIC) - t0;
+
+    stop = 1;
+    for (i = 0; i < nthreads; i++) {
+        pthread_join(w[i].thr, NULL);
+    }
+    pthread_barrier_destroy(&barrier);
+
+    qsort(seen, n, sizeof(*seen), cmp_u32);
+    for (dups = 0, i = 1; i < n; i++) {
+        dups += seen[i] == seen[i - 1];
+    }
+    printf("fork storm               %3d thr %10.1f us/fork %9.0f forks/s "
+        "%d values, %d repeated\n", nthreads, t * 1e6 / nforks,
+        nforks / t, n, dups);
+    free(seen);
+    /* A 32-bit collision is expected now and then among many values. */
+    return (dups > 1 + (int)((double)n * n / 8589934592.0));
+}
+
+static void
+usage(void)
+{
+    fprintf(stderr, "usage: arc4random_bench [-d seconds] [-f forks] "
+        "[-t threads] [calls | fork]\n");
+    exit(2);
+}
+
+int
+main(int argc, char **argv)
+{
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    int ch, docalls = 1, dofork = 1, nforks = 2000, n, fail = 0;
+    int maxthreads = ncpu > 0 ? (int)ncpu : 1;
+
+    while ((ch = getopt(argc, argv, "d:f:t:")) != -1) {
+        switch (ch) {
+        case 'd':
+            duration = strtod(optarg, NULL);
+            break;
+        case 'f':
+            nforks = (int)strtol(optarg, NULL, 0);
+            break;
+        case 't':
+            maxthreads = (int)strtol(optarg, NULL, 0);
+            break;
+        default:
+            usage();
+        }
+    }
+    argc -= optind;
+    argv += optind;
+    if (duration <= 0 || nforks < 1 || maxthreads < 1 ||
+        maxthreads > MAXTHREADS) {
+        usage();
+    }
+    if (argc > 1) {
+        usage();
+    } else if (argc == 1) {
+        if (strcmp(argv[0], "calls") == 0) {
+            dofork = 0;
+        } else if (strcmp(argv[0], "fork") == 0) {
+            docalls = 0;
+        } else {
+            usage();
+        }
+    }
+    if (docalls) {
+        bench_calls(maxthreads);
+    }
+    if (dofork) {
+        for (n = 0; n < maxthreads; n = n == 0 ? 1 : n * 2) {
+            fail |= bench_fork(nforks, n);
+        }
+    }
+    return (fail);
+}
@@ -0,0 +1,1069 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Differential fuzzer and benchmark for the gdtoa strtod family and the
+ * strtoul family.  Every conversion is checked against a slow reference
+ * parser that rounds with exact big-integer arithmetic, so a fast path
+ * that rounds wrongly, sets errno where it should not, or stops at a
+ * different character is reported with the input that triggered it.
+ * The benchmark times each corpus in MB/s and values/s; to compare two
+ * revisions, build this file against each and run both.
+ *
+ * It runs on any little-endian IEEE host.  From the top of the tree:
+ *
+ *	cc -O2 -o strto_diff lib/libc/tests/stdlib/strto_diff.c \
+ *	    contrib/gdtoa/?*.c lib/libc/gdtoa/glue.c \
+ *	    lib/libc/stdlib/strtoul.c lib/libc/stdlib/strtoumax.c \
+ *	    lib/libc/stdlib/strtoimax.c -Iinclude -Icontrib/gdtoa \
+ *	    -Ilib/libc/stdlib -Ilib/libc/aarch64 -Ilib/libc/include -lm
+ *	./strto_diff [-n count] [-s seed] [fuzz | bench]
+ *
+ * Adding -fsanitize=address also catches strnto* reading past len, as
+ * the bounded tests hand them buffers with no terminating NUL.
+ *
+ * The reference follows C99 and this tree's choices where C leaves
+ * room: ERANGE is required on overflow and on a nonzero input that
+ * rounds to zero, and allowed but not required for other results below
+ * the smallest normal; the strtoul family sets EINVAL when nothing is
+ * converted.  Only round-to-nearest is checked.
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "strnto.h"
+
+#define BIGW        1024        /* 32768 bits, enough for any input below */
+#define MAXDIG      2000        /* significant digits the reference keeps */
+#define MAXHEX      40          /* likewise for hex digits */
+#define MAXREPORT   20
+
+struct big {
+    int n;
+    uint32_t w[BIGW];
+};
+
+static uint64_t rngstate = 0x853c49e6748fea9bULL;
+static long nfail;
+
+static uint64_t
+rnd(void)
+{
+    rngstate ^= rngstate << 13;
+    rngstate ^= rngstate >> 7;
+    rngstate ^= rngstate << 17;
+    return (rngstate);
+}
+
+static unsigned
+rndn(unsigned n)
+{
+    return ((unsigned)(rnd() % n));
+}
+
+/* Big naturals, just enough for the reference. */
+
+static void
+big_set(struct big *b, uint32_t v)
+{
+    b->n = v != 0;
+    b->w[0] = v;
+}
+
+static void
+big_muladd(struct big *b, uint32_t m, uint32_t a)
+{
+    uint64_t c = a;
+    int i;
+
+    for (i = 0; i < b->n; i++) {
+        c += (uint64_t)b->w[i] * m;
+        b->w[i] = (uint32_t)c;
+        c >>= 32;
+    }
+    if (c != 0) {
+        b->w[b->n++] = (uint32_t)c;
+    }
+}
+
+static uint32_t
+big_divsmall(struct big *b, uint32_t d)
+{
+    uint64_t r = 0;
+    int i;
+
+    for (i = b->n - 1; i >= 0; i--) {
+        r = r << 32 | b->w[i];
+        b->w[i] = (uint32_t)(r / d);
+        r %= d;
+    }
+    while (b->n > 0 && b->w[b->n - 1] == 0) {
+        b->n--;
+    }
+    return ((uint32_t)r);
+}
+
+static void
+big_pow5(struct big *b, int k)
+{
+    for (; k >= 13; k -= 13) {
+        big_muladd(b, 1220703125, 0);
+    }
+    for (; k > 0; k--) {
+        big_muladd(b, 5, 0);
+    }
+}
+
+static void
+big_shl(struct big *d, const struct big *s, int k)
+{
+    int i, q = k / 32, r = k % 32;
+
+    if (s->n == 0) {
+        d->n = 0;
+        return;
+    }
+    d->w[s->n + q] = 0;
+    for (i = s->n - 1; i >= 0; i--) {
+        d->w[i + q + 1] |= r ? s->w[i] >> (32 - r) : 0;
+        d->w[i + q] = s->w[i] << r;
+    }
+    for (i = 0; i < q; i++) {
+        d->w[i] = 0;
+    }
+    d->n = s->n + q + 1;
+    while (d->n > 0 && d->w[d->n - 1] == 0) {
+        d->n--;
+    }
+}
+
+static int
+big_cmp(const struct big *a, const struct big *b)
+{
+    int i;
+
+    if (a->n != b->n) {
+        return (a->n < b->n ? -1 : 1);
+    }
+    for (i = a->n - 1; i >= 0; i--) {
+        if (a->w[i] != b->w[i]) {
+            return (a->w[i] < b->w[i] ? -1 : 1);
+        }
+    }
+    return (0);
+}
+
+static void
+big_sub(struct big *a, const struct big *b)
+{
+    int64_t c = 0;
+    int i;
+
+    for (i = 0; i < a->n; i++) {
+        c += (int64_t)a->w[i] - (i < b->n ? b->w[i] : 0);
+        a->w[i] = (uint32_t)c;
+        c = c < 0 ? -1 : 0;
+    }
+    while (a->n > 0 && a->w[a->n - 1] == 0) {
+        a->n--;
+    }
+}
+
+static int
+big_bitlen(const struct big *b)
+{
+    return (b->n == 0 ? 0 : 32 * b->n - __builtin_clz(b->w[b->n - 1]));
+}
+
+/* What the reference expects from a floating-point conversion. */
+struct fref {
+    double v;
+    const char *end;
+    const char *end2;   /* nan(...) may also end here */
+    int erange;         /* 0 never, 1 always, 2 either */
+};
+
+/*
+ * Round a * 2**t / b to prec bits for a format whose smallest subnormal
+ * is 2**emin and whose values stay below 2**emax.
+ */
+static void
+ref_round(struct big *a, struct big *b, int t, int prec, int emin, int emax,
+    struct fref *r)
+{
+    static struct big x, y, ys;
+    uint64_t m, q, rest, half;
+    int e2, i, nb, shift, target;
+
+    e2 = big_bitlen(a) - big_bitlen(b) + t - 1 - 57;
+    big_shl(&x, a, t - e2 > 0 ? t - e2 : 0);
+    big_shl(&y, b, e2 - t > 0 ? e2 - t : 0);
+    q = 0;
+    for (i = 59; i >= 0; i--) {
+        big_shl(&ys, &y, i);
+        if (big_cmp(&x, &ys) >= 0) {
+            big_sub(&x, &ys);
+            q |= 1ULL << i;
+        }
+    }
+    nb = 64 - __builtin_clzll(q);
+    target = nb - 1 + e2 - (prec - 1);
+    if (target < emin) {
+        target = emin;
+    }
+    r->erange = nb - 1 + e2 < emin + prec - 1 ? 2 : 0;
+    shift = target - e2;
+    if (shift >= 62) {
+        m = half = 0;
+        rest = 1;
+    } else {
+        m = q >> shift;
+        half = q >> (shift - 1) & 1;
+        rest = (q & ((1ULL << (shift - 1)) - 1)) | (uint64_t)(x.n != 0);
+    }
+    if (half && (rest || (m & 1))) {
+        m++;
+    }
+    if (m == 1ULL << prec) {
+        m >>= 1;
+        target++;
+    }
+    if (m == 0) {
+        r->erange = 1;
+        r->v = 0;
+    } else if (64 - __builtin_clzll(m) + target > emax) {
+        r->erange = 1;
+        r->v = HUGE_VAL;
+    } else {
+        r->v = ldexp((double)m, target);
+    }
+}
+
+static int
+hexval(int c)
+{
+    if (c >= '0' && c <= '9') {
+        return (c - '0');
+    }
+    c = tolower(c);
+    return (c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1);
+}
+
+static int
+prefix(const char *s, const char *word)
+{
+    while (*word != '\0') {
+        if (tolower((unsigned char)*s++) != *word++) {
+            return (0);
+        }
+    }
+    return (1);
+}
+
+/* Reference strtod (prec 53) or strtof (prec 24). */
+static void
+ref_strtod(const char *s0, int prec, struct fref *r)
+{
+    static struct big a, b;
+    const char *s = s0, *p;
+    long ex, pex, t;
+    int base, dig, neg, nd, nz, any, sticky;
+
+    r->end = r->end2 = s0;
+    r->erange = 0;
+    r->v = 0;
+    while (isspace((unsigned char)*s)) {
+        s++;
+    }
+    neg = *s == '-';
+    if (*s == '-' || *s == '+') {
+        s++;
+    }
+    if (prefix(s, "inf")) {
+        r->v = neg ? -HUGE_VAL : HUGE_VAL;
+        r->end = r->end2 = s + (prefix(s, "infinity") ? 8 : 3);
+        return;
+    }
+    if (prefix(s, "nan")) {
+        r->v = NAN;
+        r->end = r->end2 = s + 3;
+        if (s[3] == '(' && (p = strchr(s + 4, ')')) != NULL) {
+            r->end2 = p + 1;
+        }
+        return;
+    }
+    base = 10;
+    if (s[0] == '0' && tolower((unsigned char)s[1]) == 'x' &&
+        (hexval(s[2]) >= 0 || (s[2] == '.' && hexval(s[3]) >= 0))) {
+        base = 16;
+        s += 2;
+    }
+    big_set(&a, 0);
+    ex = pex = 0;
+    nd = nz = any = sticky = 0;
+    for (p = s;; p++) {
+        if (*p == '.' && !nz) {
+            nz = 1;
+            continue;
+        }
+        dig = base == 16 ? hexval(*p) : (*p >= '0' && *p <= '9' ? *p - '0' : -1);
+        if (dig < 0) {
+            break;
+        }
+        any = 1;
+        if (a.n == 0 && dig == 0) {
+            ex -= nz;
+        } else if (nd < (base == 16 ? MAXHEX : MAXDIG)) {
+            big_muladd(&a, base, dig);
+            nd++;
+            ex -= nz;
+        } else {
+            sticky |= dig != 0;
+            ex += !nz;
+        }
+    }
+    if (!any) {
+        return;
+    }
+    s = p;
+    if (tolower((unsigned char)*p) == (base == 16 ? 'p' : 'e')) {
+        p++;
+        dig = *p == '-';
+        if (*p == '-' || *p == '+') {
+            p++;
+        }
+        if (*p >= '0' && *p <= '9') {
+            for (t = 0; *p >= '0' && *p <= '9'; p++) {
+                if (t < 1000000) {
+                    t = t * 10 + *p - '0';
+                }
+            }
+            pex = dig ? -t : t;
+            s = p;
+        }
+    }
+    r->end = r->end2 = s;
+    if (sticky) {
+        big_muladd(&a, base, 1);
+        ex--;
+    }
+    if (a.n == 0) {
+        r->v = neg ? -0.0 : 0.0;
+        return;
+    }
+    big_set(&b, 1);
+    if (base == 16) {
+        ex = ex * 4 + pex;
+        if (ex > 4000) {
+            ex = 4000;
+        } else if (ex < -4000) {
+            ex = -4000;
+        }
+        ref_round(&a, &b, (int)ex, prec, prec == 53 ? -1074 : -149,
+            prec == 53 ? 1024 : 128, r);
+    } else {
+        ex += pex;
+        if (ex + nd > 400) {
+            ex = 400;
+        } else if (ex + nd < -400) {
+            ex = -400 - nd;
+        }
+        if (ex >= 0) {
+            big_pow5(&a, (int)ex);
+        } else {
+            big_pow5(&b, (int)-ex);
+        }
+        ref_round(&a, &b, (int)ex, prec, prec == 53 ? -1074 : -149,
+            prec == 53 ? 1024 : 128, r);
+    }
+    if (neg) {
+        r->v = -r->v;
+    }
+}
+
+/* What the reference expects from an integer conversion. */
+struct iref {
+    uintmax_t v;
+    const char *end;
+    int err;
+};
+
+/*
+ * Reference strtoul family: max is the largest magnitude of the result,
+ * and for signed results nmax that of a negative one.
+ */
+static void
+ref_strtoi(const char *s0, int base, uintmax_t max, uintmax_t nmax,
+    struct iref *r)
+{
+    const char *s = s0;
+    uintmax_t acc, lim;
+    int any, d, neg, ovf;
+
+    r->v = 0;
+    r->end = s0;
+    r->err = EINVAL;
+    while (isspace((unsigned char)*s)) {
+        s++;
+    }
+    neg = *s == '-';
+    if (*s == '-' || *s == '+') {
+        s++;
+    }
+    if ((base == 0 || base == 16) && s[0] == '0' &&
+        tolower((unsigned char)s[1]) == 'x' && hexval(s[2]) >= 0) {
+        s += 2;
+        base = 16;
+    }
+    if (base == 0) {
+        base = *s == '0' ? 8 : 10;
+    }
+    if (base < 2 || base > 36) {
+        return;
+    }
+    acc = 0;
+    any = ovf = 0;
+    for (;; s++) {
+        if (isdigit((unsigned char)*s)) {
+            d = *s - '0';
+        } else if (isalpha((unsigned char)*s)) {
+            d = tolower((unsigned char)*s) - 'a' + 10;
+        } else {
+            break;
+        }
+        if (d >= base) {
+            break;
+        }
+        any = 1;
+        lim = neg ? nmax : max;
+        if (ovf || acc > (lim - d) / base) {
+            ovf = 1;
+        } else {
+            acc = acc * base + d;
+        }
+    }
+    if (!any) {
+        return;
+    }
+    r->end = s;
+    r->err = 0;
+    if (ovf) {
+        r->err = ERANGE;
+        r->v = neg && nmax != max ? -nmax : max;
+    } else {
+        r->v = neg ? -acc : acc;
+    }
+}
+
+static void
+report(const char *what, const char *in, size_t len, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+static void
+report(const char *what, const char *in, size_t len, const char *fmt, ...)
+{
+    va_list ap;
+    size_t i;
+
+    if (nfail++ >= MAXREPORT) {
+        return;
+    }
+    printf("%s(\"", what);
+    for (i = 0; i < len && in[i] != '\0'; i++) {
+        if (isprint((unsigned char)in[i]) && in[i] != '"' && in[i] != '\\') {
+            putchar(in[i]);
+        } else {
+            printf("\\x%02x", (unsigned char)in[i]);
+        }
+    }
+    printf("\"");
+    if (len != SIZE_MAX) {
+        printf(", %zu", len);
+    }
+    printf("): ");
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    putchar('\n');
+}
+
+static void
+check_float(const char *what, const char *in, size_t len, const char *base,
+    double v, const char *end, int err, const struct fref *r)
+{
+    int same, rerr;
+
+    same = isnan(r->v) ? isnan(v) :
+        memcmp(&v, &r->v, sizeof(v)) == 0;
+    if (!same || (end != r->end && end != r->end2)) {
+        report(what, in, len, "got %a end %td, want %a end %td",
+            v, end - base, r->v, r->end - base);
+        return;
+    }
+    rerr = err == ERANGE;
+    if (err != 0 && err != ERANGE) {
+        report(what, in, len, "errno %d", err);
+    } else if (r->erange != 2 && rerr != r->erange) {
+        report(what, in, len, "%a: errno %s, want %s", v,
+            rerr ? "ERANGE" : "0", r->erange ? "ERANGE" : "0");
+    }
+}
+
+/* Check every float entry point on the NUL-terminated string s. */
+static void
+fuzz_float(const char *s)
+{
+    struct fref rd, rf;
+    char *end, *buf, *tmp;
+    size_t len, n;
+    double d;
+    float f;
+
+    ref_strtod(s, 53, &rd);
+    ref_strtod(s, 24, &rf);
+    errno = 0;
+    d = strtod(s, &end);
+    check_float("strtod", s, SIZE_MAX, s, d, end, errno, &rd);
+    errno = 0;
+    f = strtof(s, &end);
+    check_float("strtof", s, SIZE_MAX, s, f, end, errno, &rf);
+
+    /* The bounded forms get a copy with nothing after its last byte. */
+    len = strlen(s);
+    n = rndn(len + 2);
+    if (n > len) {
+        n = len;
+    }
+    tmp = strndup(s, n);
+    buf = malloc(n + (n == 0));
+    memcpy(buf, s, n);
+    ref_strtod(tmp, 53, &rd);
+    ref_strtod(tmp, 24, &rf);
+    rd.end = buf + (rd.end - tmp);
+    rd.end2 = buf + (rd.end2 - tmp);
+    rf.end = buf + (rf.end - tmp);
+    rf.end2 = buf + (rf.end2 - tmp);
+    errno = 0;
+    d = strntod(buf, n, &end);
+    check_float("strntod", s, n, buf, d, end, errno, &rd);
+    errno = 0;
+    f = strntof(buf, n, &end);
+    check_float("strntof", s, n, buf, f, end, errno, &rf);
+    free(tmp);
+    free(buf);
+}
+
+static void
+check_int(const char *what, const char *in, size_t len, const char *base,
+    int b, uintmax_t v, const char *end, int err, const struct iref *r)
+{
+    if (v != r->v || end != r->end || err != r->err) {
+        report(what, in, len,
+            "base %d: got %ju end %td errno %d, want %ju end %td errno %d",
+            b, v, end - base, err, r->v, r->end - base, r->err);
+    }
+}
+
+/* Check every integer entry point on the NUL-terminated string s. */
+static void
+fuzz_int(const char *s)
+{
+    static const int bases[] = { 0, 0, 10, 16, 8, 2, 36 };
+    struct iref r;
+    char *buf, *end, *tmp;
+    size_t len, n;
+    uintmax_t v;
+    int base;
+
+    base = rndn(4) ? bases[rndn(7)] : (int)rndn(40) - 1;
+    ref_strtoi(s, base, ULONG_MAX, ULONG_MAX, &r);
+    r.v = (unsigned long)r.v;
+    errno = 0;
+    v = strtoul(s, &end, base);
+    check_int("strtoul", s, SIZE_MAX, s, base, v, end, errno, &r);
+    ref_strtoi(s, base, UINTMAX_MAX, UINTMAX_MAX, &r);
+    errno = 0;
+    v = strtoumax(s, &end, base);
+    check_int("strtoumax", s, SIZE_MAX, s, base, v, end, errno, &r);
+    ref_strtoi(s, base, INTMAX_MAX, (uintmax_t)INTMAX_MAX + 1, &r);
+    errno = 0;
+    v = (uintmax_t)strtoimax(s, &end, base);
+    check_int("strtoimax", s, SIZE_MAX, s, base, v, end, errno, &r);
+
+    len = strlen(s);
+    n = rndn(len + 1);
+    tmp = strndup(s, n);
+    buf = malloc(n + (n == 0));
+    memcpy(buf, s, n);
+    ref_strtoi(tmp, base, ULONG_MAX, ULONG_MAX, &r);
+    r.v = (unsigned long)r.v;
+    r.end = buf + (r.end - tmp);
+    errno = 0;
+    v = strntoul(buf, n, &end, base);
+    check_int("strntoul", s, n, buf, base, v, end, errno, &r);
+    ref_strtoi(tmp, base, INTMAX_MAX, (uintmax_t)INTMAX_MAX + 1, &r);
+    r.end = buf + (r.end - tmp);
+    errno = 0;
+    v = (uintmax_t)strntoimax(buf, n, &end, base);
+    check_int("strntoimax", s, n, buf, base, v, end, errno, &r);
+    free(tmp);
+    free(buf);
+}
+
+/*
+ * Input generators.  Each writes one NUL-terminated string to p, which
+ * has room for at least 4096 bytes, and returns the end of it.
+ */
+
+static char *
+digits(char *p, int n, int lead)
+{
+    while (n-- > 0) {
+        *p++ = (lead ? '1' + rndn(9) : '0' + rndn(10));
+        lead = 0;
+    }
+    *p = '\0';
+    return (p);
+}
+
+static char *
+sign(char *p)
+{
+    switch (rndn(8)) {
+    case 0:
+        *p++ = '-';
+        break;
+    case 1:
+        *p++ = '+';
+        break;
+    case 2:
+        *p++ = ' ';
+        break;
+    }
+    return (p);
+}
+
+/* Short decimals, as in CSV and JSON. */
+static char *
+gen_short(char *p)
+{
+    p = sign(p);
+    p = digits(p, 1 + rndn(4), 0);
+    if (rndn(4)) {
+        *p++ = '.';
+        p = digits(p, rndn(5), 0);
+    }
+    return (p);
+}
+
+/* Mantissas longer than a double can hold. */
+static char *
+gen_long(char *p)
+{
+    int n = 17 + rndn(44), dot = rndn(n + 1);
+
+    p = sign(p);
+    p = digits(p, dot, 1);
+    *p++ = '.';
+    p = digits(p, n - dot, 0);
+    if (rndn(2)) {
+        p += sprintf(p, "e%d", (int)rndn(617) - 308);
+    }
+    return (p);
+}
+
+/* Subnormal doubles and floats, and the edges of both ranges. */
+static char *
+gen_subnormal(char *p)
+{
+    p = sign(p);
+    p = digits(p, 1, 1);
+    *p++ = '.';
+    p = digits(p, rndn(26), 0);
+    if (rndn(2)) {
+        p += sprintf(p, "e-%d", 300 + (int)rndn(30));
+    } else {
+        p += sprintf(p, "e-%d", 36 + (int)rndn(11));
+    }
+    return (p);
+}
+
+/* Hex floats, both what printf's %a makes and arbitrary ones. */
+static char *
+gen_hex(char *p)
+{
+    uint64_t u;
+    double d;
+    float f;
+    int i, n;
+
+    switch (rndn(3)) {
+    case 0:
+        u = rnd();
+        memcpy(&d, &u, sizeof(d));
+        if (!isfinite(d)) {
+            d = 1.0;
+        }
+        return (p + sprintf(p, "%a", d));
+    case 1:
+        u = rnd();
+        memcpy(&f, &u, sizeof(f));
+        if (!isfinite(f)) {
+            f = 1.0f;
+        }
+        return (p + sprintf(p, "%a", f));
+    }
+    p = sign(p);
+    *p++ = '0';
+    *p++ = rndn(2) ? 'x' : 'X';
+    n = 1 + rndn(30);
+    for (i = 0; i < n; i++) {
+        if (i == 1 && rndn(2)) {
+            *p++ = '.';
+        }
+        *p++ = "0123456789abcdefABCDEF"[rndn(22)];
+    }
+    p += sprintf(p, "p%d", (int)rndn(2300) - 1150);
+    return (p);
+}
+
+/* Exponents far out of range, and zeros with exponents. */
+static char *
+gen_huge(char *p)
+{
+    p = sign(p);
+    switch (rndn(4)) {
+    case 0:
+        p = digits(p, 1 + rndn(5), 1);
+        return (p + sprintf(p, "e%d", (int)rndn(200) + 300));
+    case 1:
+        p = digits(p, 1 + rndn(5), 1);
+        return (p + sprintf(p, "e-%d", (int)rndn(200) + 300));
+    case 2:
+        p = digits(p, 1 + rndn(3), 0);
+        return (p + sprintf(p, "e%s%u", rndn(2) ? "-" : "",
+            (unsigned)rnd() % 100000000));
+    }
+    *p++ = '0';
+    *p++ = '.';
+    memset(p, '0', 300 + rndn(100));
+    p += strlen(p);
+    p = digits(p, 1 + rndn(20), 1);
+    return (p + sprintf(p, "e%d", (int)rndn(700)));
+}
+
+/*
+ * The exact decimal value halfway between two adjacent doubles or
+ * floats, as is or cut short; the hardest cases to round correctly.
+ */
+static char *
+gen_halfway(char *p)
+{
+    static struct big b;
+    char tmp[1024], *t;
+    uint64_t m;
+    int e, k, n;
+    uint32_t r;
+
+    if (rndn(2)) {
+        m = rnd() >> 11;
+        e = (int)rndn(2046) - 1074;
+        m |= e > -1074 ? 1ULL << 52 : 0;
+    } else {
+        m = rnd() >> 40;
+        e = (int)rndn(254) - 149;
+        m |= e > -149 ? 1ULL << 23 : 0;
+    }
+    if (m == 0) {
+        m = 1;
+    }
+    m = 2 * m + 1;
+    k = e - 1;
+    big_set(&b, (uint32_t)m);
+    big_muladd(&b, 1, 0);
+    b.w[1] = (uint32_t)(m >> 32);
+    b.n = b.w[1] ? 2 : 1;
+    if (k >= 0) {
+        big_shl(&b, &b, k);
+        k = 0;
+    } else {
+        big_pow5(&b, -k);
+    }
+    t = tmp + sizeof(tmp);
+    *--t = '\0';
+    while (b.n > 0) {
+        r = big_divsmall(&b, 1000000000);
+        for (n = 0; n < 9; n++) {
+            *--t = '0' + r % 10;
+            r /= 10;
+        }
+    }
+    while (*t == '0') {
+        t++;
+    }
+    n = strlen(t);
+    switch (rndn(3)) {
+    case 0:
+        if (n > 17) {
+            k += n - (17 + rndn(n - 16));
+            n = 17 + rndn(n - 16);
+        }
+        break;
+    case 1:
+        memcpy(p, t, n);
+        strcpy(p + n, "0001");
+        return (p + sprintf(p + n + 4, "e%d", k - 4) + n + 4);
+    }
+    memcpy(p, t, n);
+    return (p + n + sprintf(p + n, "e%d", k));
+}
+
+/* Random bytes from the characters the parsers care about. */
+static char *
+gen_junk(char *p)
+{
+    static const char chars[] = " \t\n+-0123456789.eEpPxXaAbBfFiInNtTyY()_";
+    int n = rndn(25);
+
+    while (n-- > 0) {
+        *p++ = chars[rndn(sizeof(chars) - 1)];
+    }
+    *p = '\0';
+    return (p);
+}
+
+/* Integers in various bases, many of them at the edge of overflow. */
+static char *
+gen_int(char *p)
+{
+    static const char *const edge[] = {
+        "4294967295", "4294967296", "2147483647", "2147483648",
+        "18446744073709551615", "18446744073709551616",
+        "9223372036854775807", "9223372036854775808",
+        "9223372036854775809", "0xffffffffffffffff",
+        "0x10000000000000000", "0x7fffffffffffffff", "0x8000000000000000",
+        "01777777777777777777777", "02000000000000000000000",
+        "99999999999999999999999999",
+    };
+    int i, n;
+
+    p = sign(p);
+    if (rndn(3) == 0) {
+        return (p + sprintf(p, "%s", edge[rndn(sizeof(edge) /
+            sizeof(edge[0]))]));
+    }
+    switch (rndn(3)) {
+    case 0:
+        *p++ = '0';
+        *p++ = 'x';
+        break;
+    case 1:
+        *p++ = '0';
+        break;
+    }
+    n = 1 + rndn(24);
+    for (i = 0; i < n; i++) {
+        *p++ = "0123456789abcdefzZ"[rndn(i > 18 ? 18 : 10 + rndn(9))];
+    }
+    *p = '\0';
+    return (p);
+}
+
+struct corpus {
+    const char *name;
+    char *(*gen)(char *);
+    int isint;
+};
+
+static const struct corpus corpora[] = {
+    { "short", gen_short, 0 },
+    { "long", gen_long, 0 },
+    { "subnormal", gen_subnormal, 0 },
+    { "hex", gen_hex, 0 },
+    { "huge", gen_huge, 0 },
+    { "halfway", gen_halfway, 0 },
+    { "junk", gen_junk, 0 },
+    { "int", gen_int, 1 },
+};
+
+#define NCORPORA    (sizeof(corpora) / sizeof(corpora[0]))
+
+static void
+fuzz(long count)
+{
+    const struct corpus *c;
+    char buf[4096];
+    long i;
+
+    for (i = 0; i < count; i++) {
+        c = &corpora[rndn(NCORPORA)];
+        c->gen(buf);
+        if (!c->isint) {
+            fuzz_float(buf);
+        }
+        if (c->isint || c->gen == gen_short || c->gen == gen_junk) {
+            fuzz_int(buf);
+        }
+    }
+    printf("fuzz: %ld inputs, %ld discrepancies\n", count, nfail);
+}
+
+static double
+now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec + ts.tv_nsec * 1e-9);
+}
+
+/*
+ * Time one entry point over a corpus of count newline-separated values,
+ * repeating it until the measurement is long enough to trust.
+ */
+static void
+bench_one(const char *name, const char *fn, const char *text, size_t size,
+    long count, int which)
+{
+    volatile double sink = 0;
+    const char *p, *e = text + size;
+    char *end;
+    double t0, t;
+    long reps;
+
+    reps = 0;
+    t0 = now();
+    do {
+        for (p = text; p < e; p = end + 1) {
+            switch (which) {
+            case 0:
+                sink += strtod(p, &end);
+                break;
+            case 1:
+                sink += strtof(p, &end);
+                break;
+            default:
+                sink += strtoul(p, &end, 0);
+                break;
+            }
+            end += strcspn(end, "\n");
+        }
+        reps++;
+    } while ((t = now() - t0) < 0.25);
+    printf("%-10s %-8s %9.1f MB/s %8.2f Mvalues/s %8.1f ns/value\n",
+        name, fn, size * reps / t / 1e6, count * reps / t / 1e6,
+        t * 1e9 / (count * reps));
+}
+
+static void
+bench(long count)
+{
+    const struct corpus *c;
+    char *text, *p;
+    size_t i;
+    long j;
+
+    text = malloc(count * 4096);
+    for (i = 0; i < NCORPORA; i++) {
+        c = &corpora[i];
+        if (c->gen == gen_junk) {
+            continue;
+        }
+        for (p = text, j = 0; j < count; j++) {
+            p = c->gen(p);
+            *p++ = '\n';
+        }
+        if (c->isint) {
+            bench_one(c->name, "strtoul", text, p - text, count, 2);
+        } else {
+            bench_one(c->name, "strtod", text, p - text, count, 0);
+            bench_one(c->name, "strtof", text, p - text, count, 1);
+        }
+    }
+    free(text);
+}
+
+static void
+usage(void)
+{
+    fprintf(stderr, "usage: strto_diff [-n count] [-s seed] [fuzz | bench]\n");
+    exit(2);
+}
+
+int
+main(int argc, char **argv)
+{
+    long count = 0;
+    int ch, dobench = 1, dofuzz = 1;
+
+    while ((ch = getopt(argc, argv, "n:s:")) != -1) {
+        switch (ch) {
+        case 'n':
+            count = strtol(optarg, NULL, 0);
+            break;
+        case 's':
+            rngstate = strtoull(optarg, NULL, 0) | 1;
+            break;
+        default:
+            usage();
+        }
+    }
+    argc -= optind;
+    argv += optind;
+    if (argc > 1) {
+        usage();
+    } else if (argc == 1) {
+        if (strcmp(argv[0], "fuzz") == 0) {
+            dobench = 0;
+        } else if (strcmp(argv[0], "bench") == 0) {
+            dofuzz = 0;
+        } else {
+            usage();
+        }
+    }
+    if (dofuzz) {
+        fuzz(count > 0 ? count : 200000);
+    }
+    if (dobench) {
+        bench(count > 0 ? count : 20000);
+    }
+    return (nfail != 0);
+}
@@ -0,0 +1,128 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host-side test of rijndael-gcm.c: a known answer, a round trip, and
+ * the rejection of forged and too-short tags.  From this directory:
+ *
+ *	cc -O2 -Wall -include stdint.h -idirafter ../.. -o gcm_test \
+ *	    gcm_test.c rijndael-gcm.c rijndael-alg-fst.c && ./gcm_test
+ */
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <crypto/rijndael/rijndael-gcm.h>
+
+static int failures;
+
+#define	CHECK(exp, msg) do {						\
+	if (!(exp)) {							\
+		printf("FAIL: %s\n", (msg));				\
+		failures++;						\
+	}								\
+} while (0)
+
+/* Test case 4 of the GCM specification (McGrew and Viega). */
+static const uint8_t tc4_key[16] = {
+	0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+	0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,
+};
+static const uint8_t tc4_iv[12] = {
+	0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad,
+	0xde, 0xca, 0xf8, 0x88,
+};
+static const uint8_t tc4_aad[20] = {
+	0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+	0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+	0xab, 0xad, 0xda, 0xd2,
+};
+static const uint8_t tc4_pt[60] = {
+	0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5,
+	0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+	0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda,
+	0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+	0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53,
+	0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+	0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57,
+	0xba, 0x63, 0x7b, 0x39,
+};
+static const uint8_t tc4_tag[16] = {
+	0x5b, 0xc9, 0x4f, 0xbc, 0x32, 0x21, 0xa5, 0xdb,
+	0x94, 0xfa, 0xe9, 0x5a, 0xe7, 0x12, 0x1a, 0x47,
+};
+
+int
+main(void)
+{
+	static const size_t badlen[] = { 0, 1, 4, 8, 11, 17 };
+	rijndael_gcm_ctx ctx;
+	uint8_t ct[60], pt[60], tag[16];
+	size_t i;
+
+	rijndael_gcm_setkey(&ctx, tc4_key, 128);
+	CHECK(rijndael_gcm_seal(&ctx, tc4_iv, sizeof(tc4_iv), tc4_aad,
+	    sizeof(tc4_aad), tc4_pt, ct, sizeof(ct), tag, sizeof(tag)) == 0,
+	    "seal with a full tag");
+	CHECK(memcmp(tag, tc4_tag, sizeof(tag)) == 0, "test case 4 tag");
+
+	CHECK(rijndael_gcm_open(&ctx, tc4_iv, sizeof(tc4_iv), tc4_aad,
+	    sizeof(tc4_aad), ct, pt, sizeof(pt), tag, sizeof(tag)) == 0,
+	    "open with the right tag");
+	CHECK(memcmp(pt, tc4_pt, sizeof(pt)) == 0, "round trip");
+	CHECK(rijndael_gcm_open(&ctx, tc4_iv, sizeof(tc4_iv), tc4_aad,
+	    sizeof(tc4_aad), ct, pt, sizeof(pt), tag,
+	    RIJNDAEL_GCM_TAG_MINLEN) == 0, "open with a truncated tag");
+
+	tag[0] ^= 1;
+	CHECK(rijndael_gcm_open(&ctx, tc4_iv, sizeof(tc4_iv), tc4_aad,
+	    sizeof(tc4_aad), ct, pt, sizeof(pt), tag, sizeof(tag)) == -1,
+	    "open with a forged tag");
+	tag[0] ^= 1;
+
+	for (i = 0; i < sizeof(badlen) / sizeof(badlen[0]); i++) {
+		memset(pt, 0xaa, sizeof(pt));
+		CHECK(rijndael_gcm_open(&ctx, tc4_iv, sizeof(tc4_iv), tc4_aad,
+		    sizeof(tc4_aad), ct, pt, sizeof(pt), tag, badlen[i]) == -1,
+		    "open with a bad tag length");
+		CHECK(pt[0] == 0 && memcmp(pt, pt + 1, sizeof(pt) - 1) == 0,
+		    "output not cleared on a bad tag length");
+		CHECK(rijndael_gcm_seal(&ctx, tc4_iv, sizeof(tc4_iv), tc4_aad,
+		    sizeof(tc4_aad), tc4_pt, ct, sizeof(ct), tag, badlen[i]) == -1,
+		    "seal with a bad tag length");
+	}
+	CHECK(memcmp(tag, tc4_tag, sizeof(tag)) == 0,
+	    "seal wrote a tag with a bad tag length");
+
+	printf("%s\n", failures == 0 ? "PASS" : "FAIL");
+	return (failures != 0);
+}
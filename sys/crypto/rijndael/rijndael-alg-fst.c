@@ -37,6 +37,8 @@
 
 #include <crypto/rijndael/rijndael.h>
 #include <crypto/rijndael/rijndael_local.h>
+#include <crypto/rijndael/rijndael_hw.h>
+#include <crypto/rijndael/rijndael_ct.h>
 
 /*
 Te0[x] = S [x].[02, 01, 01, 03];
@@ -724,6 +726,14 @@ static const u32 rcon[] = {
 
 #define GETU32(pt) (((u32)(pt)[0] << 24) ^ ((u32)(pt)[1] << 16) ^ ((u32)(pt)[2] <<  8) ^ ((u32)(pt)[3]))
 #define PUTU32(ct, st) { (ct)[0] = (u8)((st) >> 24); (ct)[1] = (u8)((st) >> 16); (ct)[2] = (u8)((st) >>  8); (ct)[3] = (u8)(st); }
+#define GETU32LE(pt) (((u32)(pt)[3] << 24) ^ ((u32)(pt)[2] << 16) ^ ((u32)(pt)[1] <<  8) ^ ((u32)(pt)[0]))
+#define PUTU32LE(ct, st) { (ct)[3] = (u8)((st) >> 24); (ct)[2] = (u8)((st) >> 16); (ct)[1] = (u8)((st) >>  8); (ct)[0] = (u8)(st); }
+
+/* blocks per batch when decrypting CBC with the T-tables */
+#define CBC_BATCH 8
+
+/* blocks whose XTS tweaks are worked out at once without AES instructions */
+#define XTS_BATCH 16
 
 /**
  * Expand the cipher key into the encryption key schedule.
@@ -858,12 +868,70 @@ int rijndaelKeySetupDec(u32 rk[/*4*(Nr + 1)*/], const u8 cipherKey[], int keyBit
 	return Nr;
 }
 
+/**
+ * As rijndaelKeySetupEnc(), without table lookups.
+ *
+ * @return	the number of rounds for the given cipher key size.
+ */
+int rijndaelKeySetupEncCT(u32 rk[/*4*(Nr + 1)*/], const u8 cipherKey[], int keyBits) {
+	int i, Nk, Nr;
+	u32 temp;
+
+	KASSERT(keyBits == 128 || keyBits == 192 || keyBits == 256,
+	    ("Invalid key size (%d).", keyBits));
+	Nk = keyBits / 32;
+	Nr = Nk + 6;
+	for (i = 0; i < Nk; i++) {
+		rk[i] = GETU32(cipherKey + 4 * i);
+	}
+	for (; i < 4 * (Nr + 1); i++) {
+		temp = rk[i - 1];
+		if (i % Nk == 0) {
+			temp = ct_sub_word((temp << 8) | (temp >> 24)) ^
+			    rcon[i / Nk - 1];
+		} else if (Nk > 6 && i % Nk == 4) {
+			temp = ct_sub_word(temp);
+		}
+		rk[i] = rk[i - Nk] ^ temp;
+	}
+	return Nr;
+}
+
+/**
+ * As rijndaelKeySetupDec(), without table lookups.
+ *
+ * @return	the number of rounds for the given cipher key size.
+ */
+int rijndaelKeySetupDecCT(u32 rk[/*4*(Nr + 1)*/], const u8 cipherKey[], int keyBits) {
+	int Nr, i, j;
+	u32 temp;
+
+	Nr = rijndaelKeySetupEncCT(rk, cipherKey, keyBits);
+	for (i = 0, j = 4*Nr; i < j; i += 4, j -= 4) {
+		temp = rk[i    ]; rk[i    ] = rk[j    ]; rk[j    ] = temp;
+		temp = rk[i + 1]; rk[i + 1] = rk[j + 1]; rk[j + 1] = temp;
+		temp = rk[i + 2]; rk[i + 2] = rk[j + 2]; rk[j + 2] = temp;
+		temp = rk[i + 3]; rk[i + 3] = rk[j + 3]; rk[j + 3] = temp;
+	}
+	for (i = 4; i < 4*Nr; i++) {
+		rk[i] = ct_inv_mix_word(rk[i]);
+	}
+	return Nr;
+}
+
 void rijndaelEncrypt(const u32 rk[/*4*(Nr + 1)*/], int Nr, const u8 pt[16], u8 ct[16]) {
 	u32 s0, s1, s2, s3, t0, t1, t2, t3;
 #ifndef FULL_UNROLL
     int r;
 #endif /* ?FULL_UNROLL */
 
+#ifdef RIJNDAEL_HW
+	if (rijndael_hw_enabled()) {
+		rijndael_hw_encrypt(rk, Nr, pt, ct, 1);
+		return;
+	}
+#endif
+
     /*
 	 * map byte array block to cipher state
 	 * and add initial round key:
@@ -1045,6 +1113,13 @@ void rijndaelDecrypt(const u32 rk[/*4*(Nr + 1)*/], int Nr, const u8 ct[16], u8 p
     int r;
 #endif /* ?FULL_UNROLL */
 
+#ifdef RIJNDAEL_HW
+	if (rijndael_hw_enabled()) {
+		rijndael_hw_decrypt(rk, Nr, ct, pt, 1);
+		return;
+	}
+#endif
+
     /*
 	 * map byte array block to cipher state
 	 * and add initial round key:
@@ -1219,3 +1294,222 @@ void rijndaelDecrypt(const u32 rk[/*4*(Nr + 1)*/], int Nr, const u8 ct[16], u8 p
    		rk[3];
 	PUTU32(pt + 12, s3);
 }
+
+/**
+ * Encrypt nblocks consecutive 16-byte blocks independently (ECB).
+ * Without AES instructions, bitsliced selects the constant-time code
+ * over the T-tables.
+ */
+void rijndaelEncryptECB(const u32 rk[/*4*(Nr + 1)*/], int Nr, int bitsliced, const u8 *pt, u8 *ct, size_t nblocks) {
+#ifdef RIJNDAEL_HW
+	if (rijndael_hw_enabled()) {
+		rijndael_hw_encrypt(rk, Nr, pt, ct, nblocks);
+		return;
+	}
+#endif
+	if (bitsliced) {
+		ct_ecb(rk, Nr, pt, ct, nblocks, 0);
+		return;
+	}
+	for (; nblocks > 0; nblocks--, pt += 16, ct += 16) {
+		rijndaelEncrypt(rk, Nr, pt, ct);
+	}
+}
+
+/**
+ * Decrypt nblocks consecutive 16-byte blocks independently (ECB).
+ */
+void rijndaelDecryptECB(const u32 rk[/*4*(Nr + 1)*/], int Nr, int bitsliced, const u8 *ct, u8 *pt, size_t nblocks) {
+#ifdef RIJNDAEL_HW
+	if (rijndael_hw_enabled()) {
+		rijndael_hw_decrypt(rk, Nr, ct, pt, nblocks);
+		return;
+	}
+#endif
+	if (bitsliced) {
+		ct_ecb(rk, Nr, ct, pt, nblocks, 1);
+		return;
+	}
+	for (; nblocks > 0; nblocks--, ct += 16, pt += 16) {
+		rijndaelDecrypt(rk, Nr, ct, pt);
+	}
+}
+
+/**
+ * Encrypt nblocks 16-byte blocks in CBC mode, chaining from iv.
+ * pt and ct may be the same buffer.
+ */
+void rijndaelEncryptCBC(const u32 rk[/*4*(Nr + 1)*/], int Nr, int bitsliced, const u8 iv[16], const u8 *pt, u8 *ct, size_t nblocks) {
+	u8 block[16];
+	int i;
+
+#ifdef RIJNDAEL_HW
+	if (rijndael_hw_enabled()) {
+		rijndael_hw_cbc_encrypt(rk, Nr, iv, pt, ct, nblocks);
+		return;
+	}
+#endif
+	if (bitsliced) {
+		ct_cbc_encrypt(rk, Nr, iv, pt, ct, nblocks);
+		return;
+	}
+	for (; nblocks > 0; nblocks--, pt += 16, ct += 16) {
+		for (i = 0; i < 16; i++) {
+			block[i] = pt[i] ^ iv[i];
+		}
+		rijndaelEncrypt(rk, Nr, block, ct);
+		iv = ct;
+	}
+	explicit_bzero(block, sizeof(block));
+}
+
+/**
+ * Decrypt nblocks 16-byte blocks in CBC mode, chaining from iv.
+ * ct and pt may be the same buffer.  Unlike encryption this is parallel:
+ * a batch of blocks is decrypted first and the chaining XORs are applied
+ * to the whole batch afterwards, with the ciphertext kept aside so that
+ * in-place decryption still has it.
+ */
+void rijndaelDecryptCBC(const u32 rk[/*4*(Nr + 1)*/], int Nr, int bitsliced, const u8 iv[16], const u8 *ct, u8 *pt, size_t nblocks) {
+	u8 c[16 * (CBC_BATCH + 1)], p[16 * CBC_BATCH];
+	size_t i, n;
+
+#ifdef RIJNDAEL_HW
+	if (rijndael_hw_enabled()) {
+		rijndael_hw_cbc_decrypt(rk, Nr, iv, ct, pt, nblocks);
+		return;
+	}
+#endif
+	if (bitsliced) {
+		ct_cbc_decrypt(rk, Nr, iv, ct, pt, nblocks);
+		return;
+	}
+	/* c holds the previous ciphertext block, then this batch's */
+	memcpy(c, iv, 16);
+	for (; nblocks > 0; nblocks -= n, ct += 16 * n, pt += 16 * n) {
+		n = nblocks < CBC_BATCH ? nblocks : CBC_BATCH;
+		memcpy(c + 16, ct, 16 * n);
+		for (i = 0; i < n; i++) {
+			rijndaelDecrypt(rk, Nr, c + 16 * (i + 1), p + 16 * i);
+		}
+		for (i = 0; i < 16 * n; i++) {
+			pt[i] = p[i] ^ c[i];
+		}
+		memcpy(c, c + 16 * n, 16);
+	}
+	explicit_bzero(p, sizeof(p));
+}
+
+/**
+ * Encrypt or decrypt nblocks 16-byte blocks in CTR mode with the
+ * encryption schedule rk.  ctr is the first counter block, a 128-bit
+ * big-endian integer, and is left at the one after the last block used.
+ * in and out may be the same buffer.
+ */
+void rijndaelEncryptCTR(const u32 rk[/*4*(Nr + 1)*/], int Nr, int bitsliced, u8 ctr[16], const u8 *in, u8 *out, size_t nblocks) {
+	uint64_t c[2];
+	u8 block[16];
+	int i;
+
+	c[0] = (uint64_t)GETU32(ctr    ) << 32 | GETU32(ctr +  4);
+	c[1] = (uint64_t)GETU32(ctr + 8) << 32 | GETU32(ctr + 12);
+#ifdef RIJNDAEL_HW
+	if (rijndael_hw_enabled()) {
+		rijndael_hw_ctr(rk, Nr, c, in, out, nblocks);
+		nblocks = 0;
+	}
+#endif
+	if (bitsliced) {
+		ct_ctr(rk, Nr, c, in, out, nblocks);
+		nblocks = 0;
+	}
+	for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+		PUTU32(block     , (u32)(c[0] >> 32));
+		PUTU32(block +  4, (u32)c[0]);
+		PUTU32(block +  8, (u32)(c[1] >> 32));
+		PUTU32(block + 12, (u32)c[1]);
+		if (++c[1] == 0)
+			c[0]++;
+		rijndaelEncrypt(rk, Nr, block, block);
+		for (i = 0; i < 16; i++) {
+			out[i] = in[i] ^ block[i];
+		}
+	}
+	PUTU32(ctr     , (u32)(c[0] >> 32));
+	PUTU32(ctr +  4, (u32)c[0]);
+	PUTU32(ctr +  8, (u32)(c[1] >> 32));
+	PUTU32(ctr + 12, (u32)c[1]);
+	explicit_bzero(block, sizeof(block));
+}
+
+/*
+ * XTS without AES instructions: the tweaks for a batch of blocks are
+ * worked out first, and the batch then goes through the ECB code.
+ */
+static void rijndaelXTS(const u32 rk[/*4*(Nr + 1)*/], int Nr, int bitsliced, int decrypt, const u8 tweak[16], const u8 *in, u8 *out, size_t nblocks) {
+	u8 tw[16 * XTS_BATCH];
+	u32 t0, t1, t2, t3, carry;
+	size_t i, n;
+
+	/* the tweak is little-endian, t3 the most significant word */
+	t0 = GETU32LE(tweak     );
+	t1 = GETU32LE(tweak +  4);
+	t2 = GETU32LE(tweak +  8);
+	t3 = GETU32LE(tweak + 12);
+	for (; nblocks > 0; nblocks -= n, in += 16 * n, out += 16 * n) {
+		n = nblocks < XTS_BATCH ? nblocks : XTS_BATCH;
+		for (i = 0; i < n; i++) {
+			PUTU32LE(tw + 16 * i     , t0);
+			PUTU32LE(tw + 16 * i +  4, t1);
+			PUTU32LE(tw + 16 * i +  8, t2);
+			PUTU32LE(tw + 16 * i + 12, t3);
+			/* times x */
+			carry = (0 - (t3 >> 31)) & 0x87;
+			t3 = t3 << 1 | t2 >> 31;
+			t2 = t2 << 1 | t1 >> 31;
+			t1 = t1 << 1 | t0 >> 31;
+			t0 = t0 << 1 ^ carry;
+		}
+		for (i = 0; i < 16 * n; i++) {
+			out[i] = in[i] ^ tw[i];
+		}
+		if (decrypt) {
+			rijndaelDecryptECB(rk, Nr, bitsliced, out, out, n);
+		} else {
+			rijndaelEncryptECB(rk, Nr, bitsliced, out, out, n);
+		}
+		for (i = 0; i < 16 * n; i++) {
+			out[i] ^= tw[i];
+		}
+	}
+	explicit_bzero(tw, sizeof(tw));
+}
+
+/**
+ * Encrypt nblocks 16-byte blocks in XTS mode with the data key rk.  tweak
+ * is the encrypted tweak of the first block; each block after that uses
+ * the one before times x.  in and out may be the same buffer.
+ */
+void rijndaelEncryptXTS(const u32 rk[/*4*(Nr + 1)*/], int Nr, int bitsliced, const u8 tweak[16], const u8 *in, u8 *out, size_t nblocks) {
+#ifdef RIJNDAEL_HW
+	if (rijndael_hw_enabled()) {
+		rijndael_hw_xts_encrypt(rk, Nr, tweak, in, out, nblocks);
+		return;
+	}
+#endif
+	rijndaelXTS(rk, Nr, bitsliced, 0, tweak, in, out, nblocks);
+}
+
+/**
+ * Decrypt nblocks 16-byte blocks in XTS mode with the data decryption
+ * key rk.
+ */
+void rijndaelDecryptXTS(const u32 rk[/*4*(Nr + 1)*/], int Nr, int bitsliced, const u8 tweak[16], const u8 *in, u8 *out, size_t nblocks) {
+#ifdef RIJNDAEL_HW
+	if (rijndael_hw_enabled()) {
+		rijndael_hw_xts_decrypt(rk, Nr, tweak, in, out, nblocks);
+		return;
+	}
+#endif
+	rijndaelXTS(rk, Nr, bitsliced, 1, tweak, in, out, nblocks);
+}
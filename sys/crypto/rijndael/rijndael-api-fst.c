@@ -34,9 +34,20 @@
 
 typedef uint8_t	BYTE;
 
+#define	BITSLICED(key)	((key)->impl == RIJNDAEL_IMPL_CT)
+
 int rijndael_makeKey(keyInstance *key, BYTE direction, int keyLen,
 	const char *keyMaterial) {
 
+	return rijndael_makeKeyImpl(key, direction, keyLen, keyMaterial,
+	    RIJNDAEL_IMPL_DEFAULT);
+}
+
+int rijndael_makeKeyImpl(keyInstance *key, BYTE direction, int keyLen,
+	const char *keyMaterial, int impl) {
+	int (*setupEnc)(u32 *, const u8 *, int);
+	int (*setupDec)(u32 *, const u8 *, int);
+
 	if (key == NULL) {
 		return BAD_KEY_INSTANCE;
 	}
@@ -53,22 +64,34 @@ int rijndael_makeKey(keyInstance *key, BYTE direction, int keyLen,
 		return BAD_KEY_MAT;
 	}
 
+	if (impl == RIJNDAEL_IMPL_DEFAULT) {
+		setupEnc = rijndaelKeySetupEnc;
+		setupDec = rijndaelKeySetupDec;
+	} else if (impl == RIJNDAEL_IMPL_CT) {
+		setupEnc = rijndaelKeySetupEncCT;
+		setupDec = rijndaelKeySetupDecCT;
+	} else {
+		return BAD_KEY_INSTANCE;
+	}
+	key->impl = impl;
+
 	if (keyMaterial != NULL) {
 		memcpy(key->keyMaterial, keyMaterial, keyLen/8);
 	}
 
 	/* initialize key schedule: */
 	if (direction == DIR_ENCRYPT) {
-		key->Nr = rijndaelKeySetupEnc(key->rk, (const u8 *)(key->keyMaterial), keyLen);
+		key->Nr = setupEnc(key->rk, (const u8 *)(key->keyMaterial), keyLen);
 	} else {
-		key->Nr = rijndaelKeySetupDec(key->rk, (const u8 *)(key->keyMaterial), keyLen);
+		key->Nr = setupDec(key->rk, (const u8 *)(key->keyMaterial), keyLen);
 	}
-	rijndaelKeySetupEnc(key->ek, (const u8 *)(key->keyMaterial), keyLen);
+	setupEnc(key->ek, (const u8 *)(key->keyMaterial), keyLen);
 	return TRUE;
 }
 
 int rijndael_cipherInit(cipherInstance *cipher, BYTE mode, char *IV) {
-	if ((mode == MODE_ECB) || (mode == MODE_CBC) || (mode == MODE_CFB1)) {
+	if ((mode == MODE_ECB) || (mode == MODE_CBC) || (mode == MODE_CFB1) ||
+	    (mode == MODE_CTR)) {
 		cipher->mode = mode;
 	} else {
 		return BAD_CIPHER_MODE;
@@ -99,47 +122,18 @@ int rijndael_blockEncrypt(cipherInstance *cipher, keyInstance *key,
 
 	switch (cipher->mode) {
 	case MODE_ECB:
-		for (i = numBlocks; i > 0; i--) {
-			rijndaelEncrypt(key->rk, key->Nr, input, outBuffer);
-			input += 16;
-			outBuffer += 16;
-		}
+		rijndaelEncryptECB(key->rk, key->Nr, BITSLICED(key), input,
+		    outBuffer, numBlocks);
 		break;
 
 	case MODE_CBC:
-#if 1 /*STRICT_ALIGN*/
-		memcpy(block, cipher->IV, 16);
-		memcpy(iv, input, 16);
-		((uint32_t*)block)[0] ^= ((uint32_t*)iv)[0];
-		((uint32_t*)block)[1] ^= ((uint32_t*)iv)[1];
-		((uint32_t*)block)[2] ^= ((uint32_t*)iv)[2];
-		((uint32_t*)block)[3] ^= ((uint32_t*)iv)[3];
-#else
-		((uint32_t*)block)[0] = ((uint32_t*)cipher->IV)[0] ^ ((uint32_t*)input)[0];
-		((uint32_t*)block)[1] = ((uint32_t*)cipher->IV)[1] ^ ((uint32_t*)input)[1];
-		((uint32_t*)block)[2] = ((uint32_t*)cipher->IV)[2] ^ ((uint32_t*)input)[2];
-		((uint32_t*)block)[3] = ((uint32_t*)cipher->IV)[3] ^ ((uint32_t*)input)[3];
-#endif
-		rijndaelEncrypt(key->rk, key->Nr, block, outBuffer);
-		input += 16;
-		for (i = numBlocks - 1; i > 0; i--) {
-#if 1 /*STRICT_ALIGN*/
-			memcpy(block, outBuffer, 16);
-			memcpy(iv, input, 16);
-			((uint32_t*)block)[0] ^= ((uint32_t*)iv)[0];
-			((uint32_t*)block)[1] ^= ((uint32_t*)iv)[1];
-			((uint32_t*)block)[2] ^= ((uint32_t*)iv)[2];
-			((uint32_t*)block)[3] ^= ((uint32_t*)iv)[3];
-#else
-			((uint32_t*)block)[0] = ((uint32_t*)outBuffer)[0] ^ ((uint32_t*)input)[0];
-			((uint32_t*)block)[1] = ((uint32_t*)outBuffer)[1] ^ ((uint32_t*)input)[1];
-			((uint32_t*)block)[2] = ((uint32_t*)outBuffer)[2] ^ ((uint32_t*)input)[2];
-			((uint32_t*)block)[3] = ((uint32_t*)outBuffer)[3] ^ ((uint32_t*)input)[3];
-#endif
-			outBuffer += 16;
-			rijndaelEncrypt(key->rk, key->Nr, block, outBuffer);
-			input += 16;
-		}
+		rijndaelEncryptCBC(key->rk, key->Nr, BITSLICED(key), cipher->IV,
+		    input, outBuffer, numBlocks);
+		break;
+
+	case MODE_CTR:
+		rijndaelEncryptCTR(key->ek, key->Nr, BITSLICED(key), cipher->IV,
+		    input, outBuffer, numBlocks);
 		break;
 
 	case MODE_CFB1:
@@ -157,8 +151,8 @@ int rijndael_blockEncrypt(cipherInstance *cipher, keyInstance *key,
 				*((uint32_t*)(block+ 4)) = *((uint32_t*)iv[1]);
 				*((uint32_t*)(block+ 8)) = *((uint32_t*)iv[2]);
 				*((uint32_t*)(block+12)) = *((uint32_t*)iv[3]);
-				rijndaelEncrypt(key->ek, key->Nr, block,
-				    block);
+				rijndaelEncryptECB(key->ek, key->Nr,
+				    BITSLICED(key), block, block, 1);
 				outBuffer[k/8] ^= (block[0] & 0x80) >> (k & 7);
 				iv[0][0] = (iv[0][0] << 1) | (iv[0][1] >> 7);
 				iv[0][1] = (iv[0][1] << 1) | (iv[0][2] >> 7);
@@ -215,32 +209,26 @@ int rijndael_padEncrypt(cipherInstance *cipher, keyInstance *key,
 
 	switch (cipher->mode) {
 	case MODE_ECB:
-		for (i = numBlocks; i > 0; i--) {
-			rijndaelEncrypt(key->rk, key->Nr, input, outBuffer);
-			input += 16;
-			outBuffer += 16;
-		}
+		rijndaelEncryptECB(key->rk, key->Nr, BITSLICED(key), input,
+		    outBuffer, numBlocks);
+		input += 16*numBlocks;
+		outBuffer += 16*numBlocks;
 		padLen = 16 - (inputOctets - 16*numBlocks);
 		if (padLen <= 0 || padLen > 16)
 			return BAD_CIPHER_STATE;
 		memcpy(block, input, 16 - padLen);
 		for (cp = block + 16 - padLen; cp < block + 16; cp++)
 			*cp = padLen;
-		rijndaelEncrypt(key->rk, key->Nr, block, outBuffer);
+		rijndaelEncryptECB(key->rk, key->Nr, BITSLICED(key), block,
+		    outBuffer, 1);
 		break;
 
 	case MODE_CBC:
-		iv = cipher->IV;
-		for (i = numBlocks; i > 0; i--) {
-			((uint32_t*)block)[0] = ((const uint32_t*)input)[0] ^ ((uint32_t*)iv)[0];
-			((uint32_t*)block)[1] = ((const uint32_t*)input)[1] ^ ((uint32_t*)iv)[1];
-			((uint32_t*)block)[2] = ((const uint32_t*)input)[2] ^ ((uint32_t*)iv)[2];
-			((uint32_t*)block)[3] = ((const uint32_t*)input)[3] ^ ((uint32_t*)iv)[3];
-			rijndaelEncrypt(key->rk, key->Nr, block, outBuffer);
-			iv = outBuffer;
-			input += 16;
-			outBuffer += 16;
-		}
+		rijndaelEncryptCBC(key->rk, key->Nr, BITSLICED(key), cipher->IV,
+		    input, outBuffer, numBlocks);
+		input += 16*numBlocks;
+		outBuffer += 16*numBlocks;
+		iv = numBlocks > 0 ? outBuffer - 16 : cipher->IV;
 		padLen = 16 - (inputOctets - 16*numBlocks);
 		if (padLen <= 0 || padLen > 16)
 			return BAD_CIPHER_STATE;
@@ -250,7 +238,8 @@ int rijndael_padEncrypt(cipherInstance *cipher, keyInstance *key,
 		for (i = 16 - padLen; i < 16; i++) {
 			block[i] = (BYTE)padLen ^ iv[i];
 		}
-		rijndaelEncrypt(key->rk, key->Nr, block, outBuffer);
+		rijndaelEncryptECB(key->rk, key->Nr, BITSLICED(key), block,
+		    outBuffer, 1);
 		break;
 
 	default:
@@ -268,7 +257,8 @@ int rijndael_blockDecrypt(cipherInstance *cipher, keyInstance *key,
 
 	if (cipher == NULL ||
 		key == NULL ||
-		(cipher->mode != MODE_CFB1 && key->direction == DIR_ENCRYPT)) {
+		(cipher->mode != MODE_CFB1 && cipher->mode != MODE_CTR &&
+		key->direction == DIR_ENCRYPT)) {
 		return BAD_CIPHER_STATE;
 	}
 	if (input == NULL || inputLen <= 0) {
@@ -279,40 +269,19 @@ int rijndael_blockDecrypt(cipherInstance *cipher, keyInstance *key,
 
 	switch (cipher->mode) {
 	case MODE_ECB:
-		for (i = numBlocks; i > 0; i--) {
-			rijndaelDecrypt(key->rk, key->Nr, input, outBuffer);
-			input += 16;
-			outBuffer += 16;
-		}
+		rijndaelDecryptECB(key->rk, key->Nr, BITSLICED(key), input,
+		    outBuffer, numBlocks);
 		break;
 
 	case MODE_CBC:
-#if 1 /*STRICT_ALIGN */
-		memcpy(iv, cipher->IV, 16);
-#else
-		*((uint32_t*)iv[0]) = *((uint32_t*)(cipher->IV   ));
-		*((uint32_t*)iv[1]) = *((uint32_t*)(cipher->IV+ 4));
-		*((uint32_t*)iv[2]) = *((uint32_t*)(cipher->IV+ 8));
-		*((uint32_t*)iv[3]) = *((uint32_t*)(cipher->IV+12));
-#endif
-		for (i = numBlocks; i > 0; i--) {
-			rijndaelDecrypt(key->rk, key->Nr, input, block);
-			((uint32_t*)block)[0] ^= *((uint32_t*)iv[0]);
-			((uint32_t*)block)[1] ^= *((uint32_t*)iv[1]);
-			((uint32_t*)block)[2] ^= *((uint32_t*)iv[2]);
-			((uint32_t*)block)[3] ^= *((uint32_t*)iv[3]);
-#if 1 /*STRICT_ALIGN*/
-			memcpy(iv, input, 16);
-			memcpy(outBuffer, block, 16);
-#else
-			*((uint32_t*)iv[0]) = ((uint32_t*)input)[0]; ((uint32_t*)outBuffer)[0] = ((uint32_t*)block)[0];
-			*((uint32_t*)iv[1]) = ((uint32_t*)input)[1]; ((uint32_t*)outBuffer)[1] = ((uint32_t*)block)[1];
-			*((uint32_t*)iv[2]) = ((uint32_t*)input)[2]; ((uint32_t*)outBuffer)[2] = ((uint32_t*)block)[2];
-			*((uint32_t*)iv[3]) = ((uint32_t*)input)[3]; ((uint32_t*)outBuffer)[3] = ((uint32_t*)block)[3];
-#endif
-			input += 16;
-			outBuffer += 16;
-		}
+		rijndaelDecryptCBC(key->rk, key->Nr, BITSLICED(key), cipher->IV,
+		    input, outBuffer, numBlocks);
+		break;
+
+	case MODE_CTR:
+		/* the same as encryption, with the encryption schedule */
+		rijndaelEncryptCTR(key->ek, key->Nr, BITSLICED(key), cipher->IV,
+		    input, outBuffer, numBlocks);
 		break;
 
 	case MODE_CFB1:
@@ -330,8 +299,8 @@ int rijndael_blockDecrypt(cipherInstance *cipher, keyInstance *key,
 				*((uint32_t*)(block+ 4)) = *((uint32_t*)iv[1]);
 				*((uint32_t*)(block+ 8)) = *((uint32_t*)iv[2]);
 				*((uint32_t*)(block+12)) = *((uint32_t*)iv[3]);
-				rijndaelEncrypt(key->ek, key->Nr, block,
-				    block);
+				rijndaelEncryptECB(key->ek, key->Nr,
+				    BITSLICED(key), block, block, 1);
 				iv[0][0] = (iv[0][0] << 1) | (iv[0][1] >> 7);
 				iv[0][1] = (iv[0][1] << 1) | (iv[0][2] >> 7);
 				iv[0][2] = (iv[0][2] << 1) | (iv[0][3] >> 7);
@@ -384,13 +353,13 @@ int rijndael_padDecrypt(cipherInstance *cipher, keyInstance *key,
 	switch (cipher->mode) {
 	case MODE_ECB:
 		/* all blocks but last */
-		for (i = numBlocks - 1; i > 0; i--) {
-			rijndaelDecrypt(key->rk, key->Nr, input, outBuffer);
-			input += 16;
-			outBuffer += 16;
-		}
+		rijndaelDecryptECB(key->rk, key->Nr, BITSLICED(key), input,
+		    outBuffer, numBlocks - 1);
+		input += 16*(numBlocks - 1);
+		outBuffer += 16*(numBlocks - 1);
 		/* last block */
-		rijndaelDecrypt(key->rk, key->Nr, input, block);
+		rijndaelDecryptECB(key->rk, key->Nr, BITSLICED(key), input,
+		    block, 1);
 		padLen = block[15];
 		if (padLen >= 16) {
 			rval = BAD_DATA;
@@ -406,21 +375,17 @@ int rijndael_padDecrypt(cipherInstance *cipher, keyInstance *key,
 		break;
 
 	case MODE_CBC:
-		memcpy(iv, cipher->IV, 16);
+		/* the last block chains from the one before it */
+		memcpy(iv, numBlocks > 1 ? input + 16*(numBlocks - 2) : cipher->IV,
+		    16);
 		/* all blocks but last */
-		for (i = numBlocks - 1; i > 0; i--) {
-			rijndaelDecrypt(key->rk, key->Nr, input, block);
-			((uint32_t*)block)[0] ^= iv[0];
-			((uint32_t*)block)[1] ^= iv[1];
-			((uint32_t*)block)[2] ^= iv[2];
-			((uint32_t*)block)[3] ^= iv[3];
-			memcpy(iv, input, 16);
-			memcpy(outBuffer, block, 16);
-			input += 16;
-			outBuffer += 16;
-		}
+		rijndaelDecryptCBC(key->rk, key->Nr, BITSLICED(key), cipher->IV,
+		    input, outBuffer, numBlocks - 1);
+		input += 16*(numBlocks - 1);
+		outBuffer += 16*(numBlocks - 1);
 		/* last block */
-		rijndaelDecrypt(key->rk, key->Nr, input, block);
+		rijndaelDecryptECB(key->rk, key->Nr, BITSLICED(key), input,
+		    block, 1);
 		((uint32_t*)block)[0] ^= iv[0];
 		((uint32_t*)block)[1] ^= iv[1];
 		((uint32_t*)block)[2] ^= iv[2];
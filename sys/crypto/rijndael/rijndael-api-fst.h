@@ -18,8 +18,20 @@
 #define     MODE_ECB              1 /*  Are we ciphering in ECB mode?   */
 #define     MODE_CBC              2 /*  Are we ciphering in CBC mode?   */
 #define     MODE_CFB1             3 /*  Are we ciphering in 1-bit CFB mode? */
+#define     MODE_CTR              4 /*  Are we ciphering in counter mode? */
 #define     BITSPERBLOCK        128 /* Default number of bits in a cipher block */
 
+/*
+ *  Implementations for CPUs without AES instructions, which are used when present.
+ *  The bitsliced code is constant time.  With AVX2 it is faster than the T-tables
+ *  for ECB, CBC decryption and CTR; elsewhere those run at about the speed of the
+ *  tables or somewhat below, and serial CBC encryption is about ten times slower.
+ *  It is only reached through this API; rijndael-xts.c and rijndael-gcm.c always
+ *  use the T-tables.
+ */
+#define     RIJNDAEL_IMPL_DEFAULT 0 /*  T-tables: faster, but timing depends on key and data */
+#define     RIJNDAEL_IMPL_CT      1 /*  Bitsliced: constant time */
+
 /*  Error Codes  */
 #define     BAD_KEY_DIR          -1 /*  Key direction is invalid, e.g., unknown value */
 #define     BAD_KEY_MAT          -2 /*  Key material not of correct length */
@@ -45,17 +57,19 @@ typedef struct {
 	int   Nr;                       /* key-length-dependent number of rounds */
 	u_int32_t   rk[4*(RIJNDAEL_MAXNR + 1)];        /* key schedule */
 	u_int32_t   ek[4*(RIJNDAEL_MAXNR + 1)];        /* CFB1 key schedule (encryption only) */
+	int   impl;                     /* RIJNDAEL_IMPL_* */
 } keyInstance;
 
 /*  The structure for cipher information */
 typedef struct {                    /* changed order of the components */
-    u_int8_t mode;                  /* MODE_ECB, MODE_CBC, or MODE_CFB1 */
-    u_int8_t IV[RIJNDAEL_MAX_IV_SIZE]; /* A possible Initialization Vector for ciphering */
+    u_int8_t mode;                  /* MODE_ECB, MODE_CBC, MODE_CFB1 or MODE_CTR */
+    u_int8_t IV[RIJNDAEL_MAX_IV_SIZE]; /* A possible Initialization Vector for ciphering; the next counter block in MODE_CTR */
 } cipherInstance;
 
 /*  Function prototypes  */
 
 int rijndael_makeKey(keyInstance *, u_int8_t, int, const char *);
+int rijndael_makeKeyImpl(keyInstance *, u_int8_t, int, const char *, int);
 
 int rijndael_cipherInit(cipherInstance *, u_int8_t, char *);
 
@@ -0,0 +1,617 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * AES-GCM.  The counter mode comes from rijndaelEncryptCTR(), so it uses
+ * the AES instructions when the CPU has them.  GHASH is Shoup's method
+ * with a table of 16 multiples of H, or PCLMULQDQ on x86 and PMULL on
+ * AArch64 when present, with four blocks per reduction.
+ *
+ * Text is handled a chunk of GCM_CHUNK blocks at a time: the chunk is
+ * encrypted and then hashed while it is still in the cache, so the
+ * caller's buffer is only walked once.
+ */
+
+#include <sys/cdefs.h>
+#include <sys/types.h>
+#ifdef _KERNEL
+#include <sys/systm.h>
+#else
+#include <string.h>
+#endif
+
+#include <crypto/rijndael/rijndael.h>
+#include <crypto/rijndael/rijndael_local.h>
+#include <crypto/rijndael/rijndael-gcm.h>
+
+#if !defined(_KERNEL) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#define	GHASH_PCLMUL	1
+#elif !defined(_KERNEL) && defined(__aarch64__) && defined(__linux__) && \
+    defined(__AARCH64EL__) && (defined(__ARM_FEATURE_AES) || \
+    defined(__ARM_FEATURE_CRYPTO) || !defined(__clang__) || \
+    __clang_major__ >= 16)
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_PMULL
+#define	HWCAP_PMULL	(1 << 4)
+#endif
+#define	GHASH_PMULL	1
+#endif
+
+#define	GCM_CHUNK	256	/* blocks encrypted, then hashed: 4 KiB */
+
+/*
+ * An element of GF(2^128) is kept as two 64-bit words, most significant
+ * first, of the 16 bytes read big-endian.  GCM numbers its bits from the
+ * other end, so the coefficient of x^i is bit 127 - i and multiplying by
+ * x is a right shift.
+ */
+static inline uint64_t
+gcm_get64(const uint8_t *p)
+{
+
+	return ((uint64_t)p[0] << 56 | (uint64_t)p[1] << 48 |
+	    (uint64_t)p[2] << 40 | (uint64_t)p[3] << 32 |
+	    (uint64_t)p[4] << 24 | (uint64_t)p[5] << 16 |
+	    (uint64_t)p[6] << 8 | (uint64_t)p[7]);
+}
+
+static inline void
+gcm_put64(uint8_t *p, uint64_t v)
+{
+	int i;
+
+	for (i = 0; i < 8; i++)
+		p[i] = (uint8_t)(v >> (56 - 8 * i));
+}
+
+/* x^4 times each 4-bit remainder, reduced, as the top 16 bits of a word */
+static const uint16_t gcm_rem_4bit[16] = {
+	0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+	0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0,
+};
+
+/* Htable[n] = n * H, where the top bit of n is the coefficient of x^0. */
+static void
+gcm_init_4bit(uint64_t Htable[16][2], const uint64_t H[2])
+{
+	uint64_t V[2], T;
+	int i, j;
+
+	Htable[0][0] = Htable[0][1] = 0;
+	V[0] = H[0];
+	V[1] = H[1];
+	for (i = 8; i > 0; i >>= 1) {
+		Htable[i][0] = V[0];
+		Htable[i][1] = V[1];
+		T = 0xe100000000000000ULL & (0 - (V[1] & 1));
+		V[1] = V[0] << 63 | V[1] >> 1;
+		V[0] = (V[0] >> 1) ^ T;
+	}
+	for (i = 2; i < 16; i <<= 1) {
+		for (j = 1; j < i; j++) {
+			Htable[i + j][0] = Htable[i][0] ^ Htable[j][0];
+			Htable[i + j][1] = Htable[i][1] ^ Htable[j][1];
+		}
+	}
+}
+
+/* X = X * H, a nibble at a time from the x^127 end. */
+static void
+gcm_gmult_4bit(uint64_t X[2], const uint64_t Htable[16][2])
+{
+	uint64_t Zh, Zl;
+	u_int b, rem;
+	int cnt;
+
+	b = (u_int)X[1] & 0xff;
+	Zh = Htable[b & 0xf][0];
+	Zl = Htable[b & 0xf][1];
+	for (cnt = 15;;) {
+		rem = (u_int)Zl & 0xf;
+		Zl = Zh << 60 | Zl >> 4;
+		Zh = (Zh >> 4) ^ (uint64_t)gcm_rem_4bit[rem] << 48;
+		Zh ^= Htable[b >> 4][0];
+		Zl ^= Htable[b >> 4][1];
+		if (--cnt < 0)
+			break;
+		b = (u_int)(X[cnt / 8] >> (56 - 8 * (cnt % 8))) & 0xff;
+		rem = (u_int)Zl & 0xf;
+		Zl = Zh << 60 | Zl >> 4;
+		Zh = (Zh >> 4) ^ (uint64_t)gcm_rem_4bit[rem] << 48;
+		Zh ^= Htable[b & 0xf][0];
+		Zl ^= Htable[b & 0xf][1];
+	}
+	X[0] = Zh;
+	X[1] = Zl;
+}
+
+#if defined(GHASH_PCLMUL) || defined(GHASH_PMULL)
+#define	GHASH_HW	1
+
+#include <sys/hw_probe.h>
+
+/*
+ * Reduce the 256-bit carry-less product q[0] (most significant) to q[3]
+ * of two elements into X.  With the bits numbered backwards the product
+ * comes out one place short, so it is shifted left first; its low half
+ * then holds x^128 and up, which fold back in as x^7 + x^2 + x + 1, and
+ * the few bits that overflow from that fold in once more.
+ */
+static inline void
+ghash_reduce(uint64_t X[2], const uint64_t q[4])
+{
+	uint64_t s0, s1, s2, s3, y0, y1;
+
+	s0 = q[0] << 1 | q[1] >> 63;
+	s1 = q[1] << 1 | q[2] >> 63;
+	s2 = q[2] << 1 | q[3] >> 63;
+	s3 = q[3] << 1;
+	y0 = s2 ^ (s3 << 63) ^ (s3 << 62) ^ (s3 << 57);
+	y1 = s3;
+	X[0] = s0 ^ y0 ^ (y0 >> 1) ^ (y0 >> 2) ^ (y0 >> 7);
+	X[1] = s1 ^ y1 ^ (y1 >> 1 | y0 << 63) ^ (y1 >> 2 | y0 << 62) ^
+	    (y1 >> 7 | y0 << 57);
+}
+#endif
+
+#ifdef GHASH_PCLMUL
+#define	GHASH_TARGET	__attribute__((target("pclmul,sse2")))
+
+static int
+ghash_hw_probe(void)
+{
+	unsigned int eax, ebx, ecx, edx;
+
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		return (0);
+	return ((ecx & bit_PCLMUL) != 0 && (edx & bit_SSE2) != 0);
+}
+
+/* Add a * b, unreduced, into the low, middle and high partial sums. */
+#define	GHASH_MULADD(lo, mid, hi, a, b) do {				\
+	(lo) = _mm_xor_si128((lo), _mm_clmulepi64_si128((a), (b), 0x00));\
+	(mid) = _mm_xor_si128((mid), _mm_clmulepi64_si128((a), (b), 0x01));\
+	(mid) = _mm_xor_si128((mid), _mm_clmulepi64_si128((a), (b), 0x10));\
+	(hi) = _mm_xor_si128((hi), _mm_clmulepi64_si128((a), (b), 0x11));\
+} while (0)
+
+#define	GHASH_LOAD(p)	_mm_set_epi64x((long long)gcm_get64(p),		\
+	(long long)gcm_get64((p) + 8))
+
+GHASH_TARGET static void
+ghash_hw(uint64_t X[2], const uint64_t Hpow[4][2], const uint8_t *in,
+    size_t nblocks)
+{
+	__m128i h[4], lo, mid, hi, x;
+	uint64_t l[2], m[2], u[2], q[4];
+	int i;
+
+	for (i = 0; i < 4; i++)
+		h[i] = _mm_set_epi64x((long long)Hpow[i][0],
+		    (long long)Hpow[i][1]);
+	while (nblocks > 0) {
+		/* (X + C1)H^4 + C2 H^3 + C3 H^2 + C4 H, then one reduction */
+		i = nblocks >= 4 ? 4 : 1;
+		lo = mid = hi = _mm_setzero_si128();
+		x = _mm_xor_si128(GHASH_LOAD(in),
+		    _mm_set_epi64x((long long)X[0], (long long)X[1]));
+		GHASH_MULADD(lo, mid, hi, x, h[i - 1]);
+		if (i == 4) {
+			GHASH_MULADD(lo, mid, hi, GHASH_LOAD(in + 16), h[2]);
+			GHASH_MULADD(lo, mid, hi, GHASH_LOAD(in + 32), h[1]);
+			GHASH_MULADD(lo, mid, hi, GHASH_LOAD(in + 48), h[0]);
+		}
+		_mm_storeu_si128((__m128i *)l, lo);
+		_mm_storeu_si128((__m128i *)m, mid);
+		_mm_storeu_si128((__m128i *)u, hi);
+		q[0] = u[1];
+		q[1] = u[0] ^ m[1];
+		q[2] = l[1] ^ m[0];
+		q[3] = l[0];
+		ghash_reduce(X, q);
+		in += 16 * i;
+		nblocks -= i;
+	}
+}
+#endif /* GHASH_PCLMUL */
+
+#ifdef GHASH_PMULL
+#ifdef __clang__
+#define	GHASH_TARGET	__attribute__((target("aes")))
+#else
+#define	GHASH_TARGET	__attribute__((target("+crypto")))
+#endif
+
+static int
+ghash_hw_probe(void)
+{
+	return ((getauxval(AT_HWCAP) & HWCAP_PMULL) != 0);
+}
+
+#define	GHASH_PMUL(a, b)						\
+	vreinterpretq_u64_p128(vmull_p64((poly64_t)(a), (poly64_t)(b)))
+
+/* Add (a0:a1) * (b0:b1), unreduced, into the partial sums. */
+#define	GHASH_MULADD(lo, mid, hi, a0, a1, b) do {			\
+	(lo) = veorq_u64((lo), GHASH_PMUL((a1), (b)[1]));		\
+	(mid) = veorq_u64((mid), GHASH_PMUL((a0), (b)[1]));		\
+	(mid) = veorq_u64((mid), GHASH_PMUL((a1), (b)[0]));		\
+	(hi) = veorq_u64((hi), GHASH_PMUL((a0), (b)[0]));		\
+} while (0)
+
+GHASH_TARGET static void
+ghash_hw(uint64_t X[2], const uint64_t Hpow[4][2], const uint8_t *in,
+    size_t nblocks)
+{
+	uint64x2_t lo, mid, hi;
+	uint64_t l[2], m[2], u[2], q[4];
+	int i, j;
+
+	while (nblocks > 0) {
+		/* (X + C1)H^4 + C2 H^3 + C3 H^2 + C4 H, then one reduction */
+		i = nblocks >= 4 ? 4 : 1;
+		lo = mid = hi = vdupq_n_u64(0);
+		GHASH_MULADD(lo, mid, hi, X[0] ^ gcm_get64(in),
+		    X[1] ^ gcm_get64(in + 8), Hpow[i - 1]);
+		for (j = 1; j < i; j++)
+			GHASH_MULADD(lo, mid, hi, gcm_get64(in + 16 * j),
+			    gcm_get64(in + 16 * j + 8), Hpow[i - 1 - j]);
+		vst1q_u64(l, lo);
+		vst1q_u64(m, mid);
+		vst1q_u64(u, hi);
+		q[0] = u[1];
+		q[1] = u[0] ^ m[1];
+		q[2] = l[1] ^ m[0];
+		q[3] = l[0];
+		ghash_reduce(X, q);
+		in += 16 * i;
+		nblocks -= i;
+	}
+}
+#endif /* GHASH_PMULL */
+
+#ifdef GHASH_HW
+/* Whether the CPU has carry-less multiplication. */
+static inline int
+ghash_hw_enabled(void)
+{
+
+	return (HW_PROBE_ONCE(ghash_hw_probe) != 0);
+}
+#endif
+
+/* Hash nblocks whole blocks into X. */
+static void
+gcm_ghash(rijndael_gcm_ctx *ctx, const uint8_t *p, size_t nblocks)
+{
+
+#ifdef GHASH_HW
+	if (ghash_hw_enabled()) {
+		ghash_hw(ctx->X, ctx->Hpow, p, nblocks);
+		return;
+	}
+#endif
+	for (; nblocks > 0; nblocks--, p += 16) {
+		ctx->X[0] ^= gcm_get64(p);
+		ctx->X[1] ^= gcm_get64(p + 8);
+		gcm_gmult_4bit(ctx->X, ctx->Htable);
+	}
+}
+
+/* Hash a byte string, keeping any partial block in buf. */
+static void
+gcm_absorb(rijndael_gcm_ctx *ctx, const uint8_t *p, size_t len)
+{
+	size_t n;
+
+	for (; ctx->nbuf > 0 && len > 0; len--) {
+		ctx->buf[ctx->nbuf++] = *p++;
+		if (ctx->nbuf == 16) {
+			gcm_ghash(ctx, ctx->buf, 1);
+			ctx->nbuf = 0;
+		}
+	}
+	if (len == 0)
+		return;
+	n = len / 16;
+	gcm_ghash(ctx, p, n);
+	p += 16 * n;
+	len -= 16 * n;
+	memcpy(ctx->buf, p, len);
+	ctx->nbuf = len;
+}
+
+/* Zero-pad and hash a partial block in buf. */
+static void
+gcm_pad(rijndael_gcm_ctx *ctx)
+{
+
+	if (ctx->nbuf > 0) {
+		memset(ctx->buf + ctx->nbuf, 0, 16 - ctx->nbuf);
+		gcm_ghash(ctx, ctx->buf, 1);
+		ctx->nbuf = 0;
+	}
+}
+
+/*
+ * Run the counter mode over nblocks blocks.  GCM only increments the
+ * last 32 bits of the counter block, so a run is split where those wrap
+ * and the carry rijndaelEncryptCTR() makes into the rest is undone.
+ */
+static void
+gcm_ctr(rijndael_gcm_ctx *ctx, const uint8_t *in, uint8_t *out,
+    size_t nblocks)
+{
+	uint8_t top[12];
+	uint64_t left;
+	size_t n;
+
+	while (nblocks > 0) {
+		left = 0x100000000ULL - ((uint32_t)ctx->ctr[12] << 24 |
+		    (uint32_t)ctx->ctr[13] << 16 | (uint32_t)ctx->ctr[14] << 8 |
+		    ctx->ctr[15]);
+		n = nblocks < left ? nblocks : (size_t)left;
+		memcpy(top, ctx->ctr, 12);
+		rijndaelEncryptCTR(ctx->ek, ctx->Nr, 0, ctx->ctr, in, out, n);
+		memcpy(ctx->ctr, top, 12);
+		in += 16 * n;
+		out += 16 * n;
+		nblocks -= n;
+	}
+}
+
+/* Start on the text: pad out the additional data. */
+static void
+gcm_text(rijndael_gcm_ctx *ctx)
+{
+
+	if (!ctx->text) {
+		gcm_pad(ctx);
+		ctx->text = 1;
+	}
+}
+
+static void
+gcm_crypt(rijndael_gcm_ctx *ctx, const uint8_t *in, uint8_t *out,
+    size_t len, int decrypt)
+{
+	size_t i, n;
+	uint8_t c;
+
+	gcm_text(ctx);
+	ctx->len += len;
+	/* use up the keystream of a partial block */
+	for (; ctx->nbuf > 0 && len > 0; len--) {
+		c = *in++;
+		*out = c ^ ctx->ks[ctx->nbuf];
+		ctx->buf[ctx->nbuf++] = decrypt ? c : *out;
+		out++;
+		if (ctx->nbuf == 16) {
+			gcm_ghash(ctx, ctx->buf, 1);
+			ctx->nbuf = 0;
+		}
+	}
+	/* the ciphertext is hashed before it can be overwritten in place */
+	for (; len >= 16; len -= 16 * n, in += 16 * n, out += 16 * n) {
+		n = len / 16 < GCM_CHUNK ? len / 16 : GCM_CHUNK;
+		if (decrypt)
+			gcm_ghash(ctx, in, n);
+		gcm_ctr(ctx, in, out, n);
+		if (!decrypt)
+			gcm_ghash(ctx, out, n);
+	}
+	if (len > 0) {
+		memset(ctx->ks, 0, sizeof(ctx->ks));
+		gcm_ctr(ctx, ctx->ks, ctx->ks, 1);
+		for (i = 0; i < len; i++) {
+			c = in[i];
+			out[i] = c ^ ctx->ks[i];
+			ctx->buf[i] = decrypt ? c : out[i];
+		}
+		ctx->nbuf = len;
+	}
+}
+
+/*
+ * Key the context with keyBits (128, 192 or 256) bits of key.  Returns 0,
+ * or -1 for a bad key length.
+ */
+int
+rijndael_gcm_setkey(rijndael_gcm_ctx *ctx, const uint8_t *key, int keyBits)
+{
+	uint8_t h[16];
+	int i;
+
+	if (keyBits != 128 && keyBits != 192 && keyBits != 256)
+		return (-1);
+	ctx->Nr = rijndaelKeySetupEnc(ctx->ek, key, keyBits);
+	memset(h, 0, sizeof(h));
+	rijndaelEncrypt(ctx->ek, ctx->Nr, h, h);
+	ctx->H[0] = gcm_get64(h);
+	ctx->H[1] = gcm_get64(h + 8);
+	gcm_init_4bit(ctx->Htable, ctx->H);
+	ctx->Hpow[0][0] = ctx->H[0];
+	ctx->Hpow[0][1] = ctx->H[1];
+	for (i = 1; i < 4; i++) {
+		ctx->Hpow[i][0] = ctx->Hpow[i - 1][0];
+		ctx->Hpow[i][1] = ctx->Hpow[i - 1][1];
+		gcm_gmult_4bit(ctx->Hpow[i], ctx->Htable);
+	}
+	explicit_bzero(h, sizeof(h));
+	return (0);
+}
+
+/* Start a message with an IV, best RIJNDAEL_GCM_IV_LEN bytes long. */
+void
+rijndael_gcm_start(rijndael_gcm_ctx *ctx, const uint8_t *iv, size_t ivlen)
+{
+	uint8_t b[16];
+	int i;
+
+	ctx->X[0] = ctx->X[1] = 0;
+	ctx->nbuf = 0;
+	ctx->text = 0;
+	ctx->aadlen = 0;
+	ctx->len = 0;
+	if (ivlen == 12) {
+		memcpy(ctx->J0, iv, 12);
+		ctx->J0[12] = ctx->J0[13] = ctx->J0[14] = 0;
+		ctx->J0[15] = 1;
+	} else {
+		gcm_absorb(ctx, iv, ivlen);
+		gcm_pad(ctx);
+		gcm_put64(b, 0);
+		gcm_put64(b + 8, (uint64_t)ivlen * 8);
+		gcm_ghash(ctx, b, 1);
+		gcm_put64(ctx->J0, ctx->X[0]);
+		gcm_put64(ctx->J0 + 8, ctx->X[1]);
+		ctx->X[0] = ctx->X[1] = 0;
+	}
+	memcpy(ctx->ctr, ctx->J0, 16);
+	for (i = 15; i >= 12; i--) {
+		if (++ctx->ctr[i] != 0)
+			break;
+	}
+}
+
+void
+rijndael_gcm_aad(rijndael_gcm_ctx *ctx, const uint8_t *aad, size_t len)
+{
+
+	ctx->aadlen += len;
+	gcm_absorb(ctx, aad, len);
+}
+
+void
+rijndael_gcm_encrypt(rijndael_gcm_ctx *ctx, const uint8_t *in, uint8_t *out,
+    size_t len)
+{
+
+	gcm_crypt(ctx, in, out, len, 0);
+}
+
+void
+rijndael_gcm_decrypt(rijndael_gcm_ctx *ctx, const uint8_t *in, uint8_t *out,
+    size_t len)
+{
+
+	gcm_crypt(ctx, in, out, len, 1);
+}
+
+/* Finish the message and store the first taglen (up to 16) tag bytes. */
+void
+rijndael_gcm_final(rijndael_gcm_ctx *ctx, uint8_t *tag, size_t taglen)
+{
+	uint8_t b[16];
+	size_t i;
+
+	gcm_text(ctx);
+	gcm_pad(ctx);
+	gcm_put64(b, ctx->aadlen * 8);
+	gcm_put64(b + 8, ctx->len * 8);
+	gcm_ghash(ctx, b, 1);
+	rijndaelEncrypt(ctx->ek, ctx->Nr, ctx->J0, b);
+	gcm_put64(ctx->buf, ctx->X[0]);
+	gcm_put64(ctx->buf + 8, ctx->X[1]);
+	for (i = 0; i < taglen && i < 16; i++)
+		tag[i] = b[i] ^ ctx->buf[i];
+	explicit_bzero(b, sizeof(b));
+	explicit_bzero(ctx->X, sizeof(ctx->X));
+	explicit_bzero(ctx->ks, sizeof(ctx->ks));
+	explicit_bzero(ctx->buf, sizeof(ctx->buf));
+}
+
+/*
+ * Finish the message and compare its tag with the taglen bytes at tag in
+ * constant time.  Returns 0 if they match and -1 if not, or if taglen is
+ * outside RIJNDAEL_GCM_TAG_MINLEN to RIJNDAEL_GCM_TAG_LEN: a short tag
+ * is easily forged, and an empty one would match anything.
+ */
+int
+rijndael_gcm_check(rijndael_gcm_ctx *ctx, const uint8_t *tag, size_t taglen)
+{
+	uint8_t t[16], d;
+	size_t i;
+
+	rijndael_gcm_final(ctx, t, sizeof(t));
+	if (taglen < RIJNDAEL_GCM_TAG_MINLEN || taglen > RIJNDAEL_GCM_TAG_LEN) {
+		explicit_bzero(t, sizeof(t));
+		return (-1);
+	}
+	for (d = 0, i = 0; i < taglen; i++)
+		d |= t[i] ^ tag[i];
+	explicit_bzero(t, sizeof(t));
+	return (d == 0 ? 0 : -1);
+}
+
+/*
+ * Encrypt a whole message and make its tag.  Returns 0, or -1 without
+ * touching out or tag if taglen is outside RIJNDAEL_GCM_TAG_MINLEN to
+ * RIJNDAEL_GCM_TAG_LEN.
+ */
+int
+rijndael_gcm_seal(rijndael_gcm_ctx *ctx, const uint8_t *iv, size_t ivlen,
+    const uint8_t *aad, size_t aadlen, const uint8_t *in, uint8_t *out,
+    size_t len, uint8_t *tag, size_t taglen)
+{
+
+	if (taglen < RIJNDAEL_GCM_TAG_MINLEN || taglen > RIJNDAEL_GCM_TAG_LEN)
+		return (-1);
+	rijndael_gcm_start(ctx, iv, ivlen);
+	rijndael_gcm_aad(ctx, aad, aadlen);
+	gcm_crypt(ctx, in, out, len, 0);
+	rijndael_gcm_final(ctx, tag, taglen);
+	return (0);
+}
+
+/*
+ * Decrypt a whole message and check its tag.  Returns 0, or -1 if the
+ * tag does not match or taglen is out of range as for
+ * rijndael_gcm_check(), in which case out is cleared.
+ */
+int
+rijndael_gcm_open(rijndael_gcm_ctx *ctx, const uint8_t *iv, size_t ivlen,
+    const uint8_t *aad, size_t aadlen, const uint8_t *in, uint8_t *out,
+    size_t len, const uint8_t *tag, size_t taglen)
+{
+
+	rijndael_gcm_start(ctx, iv, ivlen);
+	rijndael_gcm_aad(ctx, aad, aadlen);
+	gcm_crypt(ctx, in, out, len, 1);
+	if (rijndael_gcm_check(ctx, tag, taglen) != 0) {
+		explicit_bzero(out, len);
+		return (-1);
+	}
+	return (0);
+}
@@ -0,0 +1,89 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RIJNDAEL_GCM_H_
+#define	_RIJNDAEL_GCM_H_
+
+#include <crypto/rijndael/rijndael.h>
+
+/*
+ * AES-GCM (NIST SP 800-38D) on top of rijndael-alg-fst.c.  A context is
+ * keyed once with rijndael_gcm_setkey() and then used for any number of
+ * messages, each of which is
+ *
+ *	rijndael_gcm_start(), rijndael_gcm_aad()*,
+ *	rijndael_gcm_encrypt()* or rijndael_gcm_decrypt()*,
+ *	rijndael_gcm_final() or rijndael_gcm_check()
+ *
+ * where the calls marked * may be repeated with any lengths.  All of the
+ * additional data must be given before the first byte of text.
+ * rijndael_gcm_seal() and rijndael_gcm_open() do a whole message at once.
+ */
+
+#define	RIJNDAEL_GCM_IV_LEN	12	/* recommended IV length */
+#define	RIJNDAEL_GCM_TAG_LEN	16	/* full tag length */
+#define	RIJNDAEL_GCM_TAG_MINLEN	12	/* shortest tag sealed or checked */
+
+typedef struct {
+	int		Nr;		/* number of rounds */
+	uint32_t	ek[4 * (RIJNDAEL_MAXNR + 1)];	/* key schedule */
+	uint64_t	H[2];		/* hash key, high half first */
+	uint64_t	Htable[16][2];	/* multiples of H for 4-bit GHASH */
+	uint64_t	Hpow[4][2];	/* H to H^4 for carry-less GHASH */
+	/* per message */
+	uint64_t	X[2];		/* GHASH accumulator */
+	uint8_t		J0[16];		/* pre-counter block */
+	uint8_t		ctr[16];	/* next counter block */
+	uint8_t		ks[16];		/* keystream of a partial block */
+	uint8_t		buf[16];	/* partial block being hashed */
+	u_int		nbuf;		/* bytes in buf */
+	int		text;		/* started on the text */
+	uint64_t	aadlen;		/* bytes of additional data */
+	uint64_t	len;		/* bytes of text */
+} rijndael_gcm_ctx;
+
+int	rijndael_gcm_setkey(rijndael_gcm_ctx *, const uint8_t *, int);
+void	rijndael_gcm_start(rijndael_gcm_ctx *, const uint8_t *, size_t);
+void	rijndael_gcm_aad(rijndael_gcm_ctx *, const uint8_t *, size_t);
+void	rijndael_gcm_encrypt(rijndael_gcm_ctx *, const uint8_t *, uint8_t *,
+	    size_t);
+void	rijndael_gcm_decrypt(rijndael_gcm_ctx *, const uint8_t *, uint8_t *,
+	    size_t);
+void	rijndael_gcm_final(rijndael_gcm_ctx *, uint8_t *, size_t);
+int	rijndael_gcm_check(rijndael_gcm_ctx *, const uint8_t *, size_t);
+
+int	rijndael_gcm_seal(rijndael_gcm_ctx *, const uint8_t *, size_t,
+	    const uint8_t *, size_t, const uint8_t *, uint8_t *, size_t,
+	    uint8_t *, size_t);
+int	rijndael_gcm_open(rijndael_gcm_ctx *, const uint8_t *, size_t,
+	    const uint8_t *, size_t, const uint8_t *, uint8_t *, size_t,
+	    const uint8_t *, size_t);
+
+#endif /* _RIJNDAEL_GCM_H_ */
@@ -0,0 +1,111 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * XTS-AES.  rijndaelEncryptXTS() and rijndaelDecryptXTS() do the blocks
+ * of a sector: with AES instructions four at a time with the tweaks
+ * kept in registers, and otherwise a batch of tweaks at a time through
+ * the multi-block ECB code.
+ */
+
+#include <sys/cdefs.h>
+#include <sys/types.h>
+#ifdef _KERNEL
+#include <sys/systm.h>
+#else
+#include <string.h>
+#endif
+
+#include <crypto/rijndael/rijndael.h>
+#include <crypto/rijndael/rijndael_local.h>
+#include <crypto/rijndael/rijndael-xts.h>
+
+static int
+xts_crypt(const rijndael_xts_ctx *ctx, uint64_t sector, const uint8_t *in,
+    uint8_t *out, size_t len, int decrypt)
+{
+	uint8_t tweak[16];
+	int i;
+
+	if (len == 0 || len % 16 != 0)
+		return (-1);
+
+	/* The first tweak is the sector number, little-endian, encrypted. */
+	for (i = 0; i < 8; i++)
+		tweak[i] = (uint8_t)(sector >> (8 * i));
+	memset(tweak + 8, 0, 8);
+	rijndaelEncrypt(ctx->tk, ctx->Nr, tweak, tweak);
+	if (decrypt)
+		rijndaelDecryptXTS(ctx->dk, ctx->Nr, 0, tweak, in, out,
+		    len / 16);
+	else
+		rijndaelEncryptXTS(ctx->ek, ctx->Nr, 0, tweak, in, out,
+		    len / 16);
+	explicit_bzero(tweak, sizeof(tweak));
+	return (0);
+}
+
+/*
+ * Key the context with keyBits (256 or 512) bits: the data key, then the
+ * tweak key.  Returns 0, or -1 for a bad key length.
+ */
+int
+rijndael_xts_setkey(rijndael_xts_ctx *ctx, const uint8_t *key, int keyBits)
+{
+
+	if (keyBits != 256 && keyBits != 512)
+		return (-1);
+	keyBits /= 2;
+	ctx->Nr = rijndaelKeySetupEnc(ctx->ek, key, keyBits);
+	rijndaelKeySetupDec(ctx->dk, key, keyBits);
+	rijndaelKeySetupEnc(ctx->tk, key + keyBits / 8, keyBits);
+	return (0);
+}
+
+/*
+ * Encrypt the len bytes of sector number sector from in to out, which may
+ * be the same buffer.  Returns 0, or -1 if len is not a whole number of
+ * blocks.
+ */
+int
+rijndael_xts_encrypt(const rijndael_xts_ctx *ctx, uint64_t sector,
+    const uint8_t *in, uint8_t *out, size_t len)
+{
+
+	return (xts_crypt(ctx, sector, in, out, len, 0));
+}
+
+int
+rijndael_xts_decrypt(const rijndael_xts_ctx *ctx, uint64_t sector,
+    const uint8_t *in, uint8_t *out, size_t len)
+{
+
+	return (xts_crypt(ctx, sector, in, out, len, 1));
+}
@@ -0,0 +1,57 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RIJNDAEL_XTS_H_
+#define	_RIJNDAEL_XTS_H_
+
+#include <crypto/rijndael/rijndael.h>
+
+/*
+ * XTS-AES (IEEE Std 1619, NIST SP 800-38E) for sector encryption.  The
+ * key is the data key followed by the tweak key, 256 bits in all for
+ * XTS-AES-128 and 512 for XTS-AES-256.  Each call encrypts or decrypts
+ * one whole sector, whose number is the tweak; the length must be a
+ * non-zero multiple of 16, as sectors of 512 or 4096 bytes are.
+ */
+
+typedef struct {
+	int		Nr;		/* number of rounds */
+	uint32_t	ek[4 * (RIJNDAEL_MAXNR + 1)];	/* data encrypt key */
+	uint32_t	dk[4 * (RIJNDAEL_MAXNR + 1)];	/* data decrypt key */
+	uint32_t	tk[4 * (RIJNDAEL_MAXNR + 1)];	/* tweak key */
+} rijndael_xts_ctx;
+
+int	rijndael_xts_setkey(rijndael_xts_ctx *, const uint8_t *, int);
+int	rijndael_xts_encrypt(const rijndael_xts_ctx *, uint64_t,
+	    const uint8_t *, uint8_t *, size_t);
+int	rijndael_xts_decrypt(const rijndael_xts_ctx *, uint64_t,
+	    const uint8_t *, uint8_t *, size_t);
+
+#endif /* _RIJNDAEL_XTS_H_ */
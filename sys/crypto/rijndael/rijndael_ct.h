@@ -0,0 +1,963 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Constant-time bitsliced AES for rijndael-alg-fst.c, for CPUs without
+ * AES instructions.  There are no table lookups or branches that depend
+ * on the key or the data, so unlike the T-tables it does not leak through
+ * the cache.
+ *
+ * Blocks are processed several at a time in the layout of BearSSL's
+ * aes_ct64.  A "plane" q[b] holds bit b of every byte of every block:
+ * within each 64-bit lane, bit 16 * row + 4 * column + block is the bit
+ * of that block's state byte at (row, column), so ShiftRows is a few
+ * masks and shifts within each row's 16 bits and MixColumns is rotations
+ * by whole rows.  Four blocks fit a lane.  The round functions are macros
+ * over the plane type, and ct_batches() is built from them once per
+ * width: two lanes in a 128-bit vector, SSE2 or NEON, for eight blocks;
+ * on x86 also four lanes in a 256-bit vector for sixteen, used when the
+ * CPU has AVX2; and a plain 64-bit word for four in the kernel, which may
+ * not use vector registers here, and on big-endian CPUs.  Blocks are
+ * loaded a vector at a time and split into the planes with shuffles,
+ * shifts and masks.  The round keys are bitsliced once per call into a
+ * single lane, which each batch function copies across its vectors.
+ * SubBytes is the Boyar-Peralta circuit of 113 gates, and InvSubBytes
+ * wraps it in the inverse affine transform.
+ *
+ * CBC encryption and single blocks cannot fill the lanes, so they use a
+ * one-block form instead: each plane is a 32-bit word whose two halves
+ * both hold bit 4 * column + row of the state, and rotating the whole
+ * word then rotates each half, which is all ShiftRows and MixColumns
+ * need.
+ *
+ * The key schedules are built without tables too, and come out word for
+ * word the same as rijndaelKeySetupEnc() and rijndaelKeySetupDec(), so
+ * the CT and hardware paths can share them.
+ */
+
+#ifndef _RIJNDAEL_CT_H_
+#define	_RIJNDAEL_CT_H_
+
+#if !defined(_KERNEL) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define	CT_VECTOR	1
+typedef uint64_t	ct_v2 __attribute__((vector_size(16)));
+#if defined(__x86_64__) || defined(__i386__)
+#include <sys/hw_probe.h>
+#define	CT_AVX2		1
+typedef uint64_t	ct_v4 __attribute__((vector_size(32)));
+#endif
+#endif
+
+/* Blocks per call to a ct_batches_fn in the CBC and CTR loops. */
+#define	CT_BLOCKS	16
+
+#define	CT_DEC32LE(p)	((u32)(p)[0] | (u32)(p)[1] << 8 |		\
+	    (u32)(p)[2] << 16 | (u32)(p)[3] << 24)
+
+/*
+ * SubBytes on planes q[0..7] of any word type: x0..x7 are the bits of
+ * each byte from the most significant down.
+ */
+#define	CT_SBOX(word, q) do {						\
+	word x0, x1, x2, x3, x4, x5, x6, x7;				\
+	word y1, y2, y3, y4, y5, y6, y7, y8, y9;			\
+	word y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;		\
+	word y20, y21;							\
+	word z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;			\
+	word z10, z11, z12, z13, z14, z15, z16, z17;			\
+	word t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;			\
+	word t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;		\
+	word t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;		\
+	word t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;		\
+	word t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;		\
+	word t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;		\
+	word t60, t61, t62, t63, t64, t65, t66, t67;			\
+	word s0, s1, s2, s3, s4, s5, s6, s7;				\
+									\
+	x0 = (q)[7];							\
+	x1 = (q)[6];							\
+	x2 = (q)[5];							\
+	x3 = (q)[4];							\
+	x4 = (q)[3];							\
+	x5 = (q)[2];							\
+	x6 = (q)[1];							\
+	x7 = (q)[0];							\
+									\
+	/* top linear transformation */					\
+	y14 = x3 ^ x5;							\
+	y13 = x0 ^ x6;							\
+	y9 = x0 ^ x3;							\
+	y8 = x0 ^ x5;							\
+	t0 = x1 ^ x2;							\
+	y1 = t0 ^ x7;							\
+	y4 = y1 ^ x3;							\
+	y12 = y13 ^ y14;						\
+	y2 = y1 ^ x0;							\
+	y5 = y1 ^ x6;							\
+	y3 = y5 ^ y8;							\
+	t1 = x4 ^ y12;							\
+	y15 = t1 ^ x5;							\
+	y20 = t1 ^ x1;							\
+	y6 = y15 ^ x7;							\
+	y10 = y15 ^ t0;							\
+	y11 = y20 ^ y9;							\
+	y7 = x7 ^ y11;							\
+	y17 = y10 ^ y11;						\
+	y19 = y10 ^ y8;							\
+	y16 = t0 ^ y11;							\
+	y21 = y13 ^ y16;						\
+	y18 = x0 ^ y16;							\
+									\
+	/* non-linear section: inversion in GF(2^8) */			\
+	t2 = y12 & y15;							\
+	t3 = y3 & y6;							\
+	t4 = t3 ^ t2;							\
+	t5 = y4 & x7;							\
+	t6 = t5 ^ t2;							\
+	t7 = y13 & y16;							\
+	t8 = y5 & y1;							\
+	t9 = t8 ^ t7;							\
+	t10 = y2 & y7;							\
+	t11 = t10 ^ t7;							\
+	t12 = y9 & y11;							\
+	t13 = y14 & y17;						\
+	t14 = t13 ^ t12;						\
+	t15 = y8 & y10;							\
+	t16 = t15 ^ t12;						\
+	t17 = t4 ^ t14;							\
+	t18 = t6 ^ t16;							\
+	t19 = t9 ^ t14;							\
+	t20 = t11 ^ t16;						\
+	t21 = t17 ^ y20;						\
+	t22 = t18 ^ y19;						\
+	t23 = t19 ^ y21;						\
+	t24 = t20 ^ y18;						\
+									\
+	t25 = t21 ^ t22;						\
+	t26 = t21 & t23;						\
+	t27 = t24 ^ t26;						\
+	t28 = t25 & t27;						\
+	t29 = t28 ^ t22;						\
+	t30 = t23 ^ t24;						\
+	t31 = t22 ^ t26;						\
+	t32 = t31 & t30;						\
+	t33 = t32 ^ t24;						\
+	t34 = t23 ^ t33;						\
+	t35 = t27 ^ t33;						\
+	t36 = t24 & t35;						\
+	t37 = t36 ^ t34;						\
+	t38 = t27 ^ t36;						\
+	t39 = t29 & t38;						\
+	t40 = t25 ^ t39;						\
+									\
+	t41 = t40 ^ t37;						\
+	t42 = t29 ^ t33;						\
+	t43 = t29 ^ t40;						\
+	t44 = t33 ^ t37;						\
+	t45 = t42 ^ t41;						\
+	z0 = t44 & y15;							\
+	z1 = t37 & y6;							\
+	z2 = t33 & x7;							\
+	z3 = t43 & y16;							\
+	z4 = t40 & y1;							\
+	z5 = t29 & y7;							\
+	z6 = t42 & y11;							\
+	z7 = t45 & y17;							\
+	z8 = t41 & y10;							\
+	z9 = t44 & y12;							\
+	z10 = t37 & y3;							\
+	z11 = t33 & y4;							\
+	z12 = t43 & y13;						\
+	z13 = t40 & y5;							\
+	z14 = t29 & y2;							\
+	z15 = t42 & y9;							\
+	z16 = t45 & y14;						\
+	z17 = t41 & y8;							\
+									\
+	/* bottom linear transformation */				\
+	t46 = z15 ^ z16;						\
+	t47 = z10 ^ z11;						\
+	t48 = z5 ^ z13;							\
+	t49 = z9 ^ z10;							\
+	t50 = z2 ^ z12;							\
+	t51 = z2 ^ z5;							\
+	t52 = z7 ^ z8;							\
+	t53 = z0 ^ z3;							\
+	t54 = z6 ^ z7;							\
+	t55 = z16 ^ z17;						\
+	t56 = z12 ^ t48;						\
+	t57 = t50 ^ t53;						\
+	t58 = z4 ^ t46;							\
+	t59 = z3 ^ t54;							\
+	t60 = t46 ^ t57;						\
+	t61 = z14 ^ t57;						\
+	t62 = t52 ^ t58;						\
+	t63 = t49 ^ t58;						\
+	t64 = z4 ^ t59;							\
+	t65 = t61 ^ t62;						\
+	t66 = z1 ^ t63;							\
+	s0 = t59 ^ t63;							\
+	s6 = t56 ^ ~t62;						\
+	s7 = t48 ^ ~t60;						\
+	t67 = t64 ^ t65;						\
+	s3 = t53 ^ t66;							\
+	s4 = t51 ^ t66;							\
+	s5 = t47 ^ t65;							\
+	s1 = t64 ^ ~s3;							\
+	s2 = t55 ^ ~t67;						\
+									\
+	(q)[7] = s0;							\
+	(q)[6] = s1;							\
+	(q)[5] = s2;							\
+	(q)[4] = s3;							\
+	(q)[3] = s4;							\
+	(q)[2] = s5;							\
+	(q)[1] = s6;							\
+	(q)[0] = s7;							\
+} while (0)
+
+/*
+ * The inverse affine transform of SubBytes, x -> A^-1(x ^ 0x63).  The
+ * inverse S-box is this, then the S-box, then this again, since the
+ * field inversion in the middle is its own inverse.
+ */
+#define	CT_INV_AFFINE(word, q) do {					\
+	word q0, q1, q2, q3, q4, q5, q6, q7;				\
+									\
+	q0 = ~(q)[0];							\
+	q1 = ~(q)[1];							\
+	q2 = (q)[2];							\
+	q3 = (q)[3];							\
+	q4 = (q)[4];							\
+	q5 = ~(q)[5];							\
+	q6 = ~(q)[6];							\
+	q7 = (q)[7];							\
+	(q)[7] = q1 ^ q4 ^ q6;						\
+	(q)[6] = q0 ^ q3 ^ q5;						\
+	(q)[5] = q7 ^ q2 ^ q4;						\
+	(q)[4] = q6 ^ q1 ^ q3;						\
+	(q)[3] = q5 ^ q0 ^ q2;						\
+	(q)[2] = q4 ^ q7 ^ q1;						\
+	(q)[1] = q3 ^ q6 ^ q0;						\
+	(q)[0] = q2 ^ q5 ^ q7;						\
+} while (0)
+
+/* Rotate rows 2 and 3 right by two columns, then rows 1 and 3 by one. */
+#define	CT_SHIFT_ROWS(word, q) do {					\
+	word x_;							\
+	int i_;								\
+									\
+	for (i_ = 0; i_ < 8; i_++) {					\
+		x_ = (q)[i_];						\
+		x_ = (x_ & 0x00000000FFFFFFFFULL)			\
+		    | ((x_ >> 8) & 0x00FF00FF00000000ULL)		\
+		    | ((x_ << 8) & 0xFF00FF0000000000ULL);		\
+		(q)[i_] = (x_ & 0x0000FFFF0000FFFFULL)			\
+		    | ((x_ >> 4) & 0x0FFF00000FFF0000ULL)		\
+		    | ((x_ << 12) & 0xF0000000F0000000ULL);		\
+	}								\
+} while (0)
+
+#define	CT_INV_SHIFT_ROWS(word, q) do {					\
+	word x_;							\
+	int i_;								\
+									\
+	for (i_ = 0; i_ < 8; i_++) {					\
+		x_ = (q)[i_];						\
+		x_ = (x_ & 0x0000FFFF0000FFFFULL)			\
+		    | ((x_ << 4) & 0xFFF00000FFF00000ULL)		\
+		    | ((x_ >> 12) & 0x000F0000000F0000ULL);		\
+		(q)[i_] = (x_ & 0x00000000FFFFFFFFULL)			\
+		    | ((x_ >> 8) & 0x00FF00FF00000000ULL)		\
+		    | ((x_ << 8) & 0xFF00FF0000000000ULL);		\
+	}								\
+} while (0)
+
+#define	CT_ROTR16(x)	(((x) >> 16) | ((x) << 48))
+#define	CT_ROTR32(x)	(((x) >> 32) | ((x) << 32))
+
+/*
+ * With r the state moved up one row, q ^ r is a[i] ^ a[i+1] and its
+ * rotation by two rows a[i+2] ^ a[i+3], so each output byte is
+ * 2 * (q ^ r) ^ r ^ rotr32(q ^ r); multiplying by 2 in the planes is a
+ * shift from plane b to b + 1 with plane 7 folded back in as 0x1b.
+ */
+#define	CT_MIX_COLUMNS(word, q, ROW1, ROW2) do {			\
+	word q0, q1, q2, q3, q4, q5, q6, q7;				\
+	word r0, r1, r2, r3, r4, r5, r6, r7;				\
+									\
+	q0 = (q)[0];							\
+	q1 = (q)[1];							\
+	q2 = (q)[2];							\
+	q3 = (q)[3];							\
+	q4 = (q)[4];							\
+	q5 = (q)[5];							\
+	q6 = (q)[6];							\
+	q7 = (q)[7];							\
+	r0 = ROW1(q0);							\
+	r1 = ROW1(q1);							\
+	r2 = ROW1(q2);							\
+	r3 = ROW1(q3);							\
+	r4 = ROW1(q4);							\
+	r5 = ROW1(q5);							\
+	r6 = ROW1(q6);							\
+	r7 = ROW1(q7);							\
+									\
+	(q)[0] = q7 ^ r7 ^ r0 ^ ROW2(q0 ^ r0);				\
+	(q)[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ ROW2(q1 ^ r1);		\
+	(q)[2] = q1 ^ r1 ^ r2 ^ ROW2(q2 ^ r2);				\
+	(q)[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ ROW2(q3 ^ r3);		\
+	(q)[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ ROW2(q4 ^ r4);		\
+	(q)[5] = q4 ^ r4 ^ r5 ^ ROW2(q5 ^ r5);				\
+	(q)[6] = q5 ^ r5 ^ r6 ^ ROW2(q6 ^ r6);				\
+	(q)[7] = q6 ^ r6 ^ r7 ^ ROW2(q7 ^ r7);				\
+} while (0)
+
+/*
+ * InvMixColumns is MixColumns after adding 4 * (a[i] ^ a[i+2]) to every
+ * a[i].
+ */
+#define	CT_INV_MIX_COLUMNS(word, q) do {				\
+	word t_[8], u_[8];						\
+	int i_;								\
+									\
+	for (i_ = 0; i_ < 8; i_++)					\
+		t_[i_] = (q)[i_] ^ CT_ROTR32((q)[i_]);			\
+	/* u = 4 * t */							\
+	u_[0] = t_[6];							\
+	u_[1] = t_[6] ^ t_[7];						\
+	u_[2] = t_[0] ^ t_[7];						\
+	u_[3] = t_[1] ^ t_[6];						\
+	u_[4] = t_[2] ^ t_[6] ^ t_[7];					\
+	u_[5] = t_[3] ^ t_[7];						\
+	u_[6] = t_[4];							\
+	u_[7] = t_[5];							\
+	for (i_ = 0; i_ < 8; i_++)					\
+		(q)[i_] ^= u_[i_];					\
+	CT_MIX_COLUMNS(word, q, CT_ROTR16, CT_ROTR32);			\
+} while (0)
+
+#define	CT_SWAPMOVE(word, a, b, m, n) do {				\
+	word t_ = (((a) >> (n)) ^ (b)) & (m);				\
+	(b) ^= t_;							\
+	(a) ^= t_ << (n);						\
+} while (0)
+
+/*
+ * Transpose the 8x8 bit matrices made of byte k of q[0..7], for every k,
+ * so that bit j of byte k of q[b] becomes bit b of byte k of q[j].  It is
+ * its own inverse.
+ */
+#define	CT_ORTHO(word, q) do {						\
+	CT_SWAPMOVE(word, (q)[0], (q)[1], 0x5555555555555555ULL, 1);	\
+	CT_SWAPMOVE(word, (q)[2], (q)[3], 0x5555555555555555ULL, 1);	\
+	CT_SWAPMOVE(word, (q)[4], (q)[5], 0x5555555555555555ULL, 1);	\
+	CT_SWAPMOVE(word, (q)[6], (q)[7], 0x5555555555555555ULL, 1);	\
+	CT_SWAPMOVE(word, (q)[0], (q)[2], 0x3333333333333333ULL, 2);	\
+	CT_SWAPMOVE(word, (q)[1], (q)[3], 0x3333333333333333ULL, 2);	\
+	CT_SWAPMOVE(word, (q)[4], (q)[6], 0x3333333333333333ULL, 2);	\
+	CT_SWAPMOVE(word, (q)[5], (q)[7], 0x3333333333333333ULL, 2);	\
+	CT_SWAPMOVE(word, (q)[0], (q)[4], 0x0f0f0f0f0f0f0f0fULL, 4);	\
+	CT_SWAPMOVE(word, (q)[1], (q)[5], 0x0f0f0f0f0f0f0f0fULL, 4);	\
+	CT_SWAPMOVE(word, (q)[2], (q)[6], 0x0f0f0f0f0f0f0f0fULL, 4);	\
+	CT_SWAPMOVE(word, (q)[3], (q)[7], 0x0f0f0f0f0f0f0f0fULL, 4);	\
+} while (0)
+
+/*
+ * Spread the four little-endian words w0..w3 of a block, its columns,
+ * over q0 and q1 ready for CT_ORTHO(): byte k of q0 is row k / 2 of
+ * column 2 * (k % 2) and byte k of q1 the same row of the next column.
+ */
+#define	CT_INTERLEAVE_IN(word, q0, q1, w0, w1, w2, w3) do {		\
+	word a_ = (w0), b_ = (w1), c_ = (w2), d_ = (w3);		\
+									\
+	a_ = (a_ | (a_ << 16)) & 0x0000FFFF0000FFFFULL;			\
+	b_ = (b_ | (b_ << 16)) & 0x0000FFFF0000FFFFULL;			\
+	c_ = (c_ | (c_ << 16)) & 0x0000FFFF0000FFFFULL;			\
+	d_ = (d_ | (d_ << 16)) & 0x0000FFFF0000FFFFULL;			\
+	a_ = (a_ | (a_ << 8)) & 0x00FF00FF00FF00FFULL;			\
+	b_ = (b_ | (b_ << 8)) & 0x00FF00FF00FF00FFULL;			\
+	c_ = (c_ | (c_ << 8)) & 0x00FF00FF00FF00FFULL;			\
+	d_ = (d_ | (d_ << 8)) & 0x00FF00FF00FF00FFULL;			\
+	(q0) = a_ | (c_ << 8);						\
+	(q1) = b_ | (d_ << 8);						\
+} while (0)
+
+/* The inverse of CT_INTERLEAVE_IN(), leaving each column in a lane. */
+#define	CT_INTERLEAVE_OUT(word, w, q0, q1) do {				\
+	word a_, b_, c_, d_;						\
+									\
+	a_ = (q0) & 0x00FF00FF00FF00FFULL;				\
+	b_ = (q1) & 0x00FF00FF00FF00FFULL;				\
+	c_ = ((q0) >> 8) & 0x00FF00FF00FF00FFULL;			\
+	d_ = ((q1) >> 8) & 0x00FF00FF00FF00FFULL;			\
+	a_ = (a_ | (a_ >> 8)) & 0x0000FFFF0000FFFFULL;			\
+	b_ = (b_ | (b_ >> 8)) & 0x0000FFFF0000FFFFULL;			\
+	c_ = (c_ | (c_ >> 8)) & 0x0000FFFF0000FFFFULL;			\
+	d_ = (d_ | (d_ >> 8)) & 0x0000FFFF0000FFFFULL;			\
+	(w)[0] = (a_ | (a_ >> 16)) & 0xFFFFFFFFULL;			\
+	(w)[1] = (b_ | (b_ >> 16)) & 0xFFFFFFFFULL;			\
+	(w)[2] = (c_ | (c_ >> 16)) & 0xFFFFFFFFULL;			\
+	(w)[3] = (d_ | (d_ >> 16)) & 0xFFFFFFFFULL;			\
+} while (0)
+
+#define	CT_ADD_ROUND_KEY(q, k) do {					\
+	int j_;								\
+									\
+	for (j_ = 0; j_ < 8; j_++)					\
+		(q)[j_] ^= (k)[j_];					\
+} while (0)
+
+#define	CT_ENCRYPT(word, k, Nr, q) do {					\
+	int r_;								\
+									\
+	CT_ADD_ROUND_KEY(q, (k)[0]);					\
+	for (r_ = 1; r_ < (Nr); r_++) {					\
+		CT_SBOX(word, q);					\
+		CT_SHIFT_ROWS(word, q);					\
+		CT_MIX_COLUMNS(word, q, CT_ROTR16, CT_ROTR32);		\
+		CT_ADD_ROUND_KEY(q, (k)[r_]);				\
+	}								\
+	CT_SBOX(word, q);						\
+	CT_SHIFT_ROWS(word, q);						\
+	CT_ADD_ROUND_KEY(q, (k)[Nr]);					\
+} while (0)
+
+/* The equivalent inverse cipher, for rijndaelKeySetupDec()'s schedule. */
+#define	CT_DECRYPT(word, k, Nr, q) do {					\
+	int r_;								\
+									\
+	CT_ADD_ROUND_KEY(q, (k)[0]);					\
+	for (r_ = 1; r_ < (Nr); r_++) {					\
+		CT_INV_AFFINE(word, q);					\
+		CT_SBOX(word, q);					\
+		CT_INV_AFFINE(word, q);					\
+		CT_INV_SHIFT_ROWS(word, q);				\
+		CT_INV_MIX_COLUMNS(word, q);				\
+		CT_ADD_ROUND_KEY(q, (k)[r_]);				\
+	}								\
+	CT_INV_AFFINE(word, q);						\
+	CT_SBOX(word, q);						\
+	CT_INV_AFFINE(word, q);						\
+	CT_INV_SHIFT_ROWS(word, q);					\
+	CT_ADD_ROUND_KEY(q, (k)[Nr]);					\
+} while (0)
+
+/*
+ * Load 4 * lanes blocks: block lanes * i + l goes to lane l of words i
+ * and i + 4 before CT_ORTHO().  Each group of lanes blocks is loaded
+ * whole and split into the low and high halves of the blocks with two
+ * shuffles, LO and HI.
+ */
+#define	CT_LOAD(word, lanes, q, in, LO, HI) do {			\
+	word a_, b_, lo_, hi_;						\
+	int i_;								\
+									\
+	for (i_ = 0; i_ < 4; i_++) {					\
+		memcpy(&a_, (in) + 16 * (lanes) * i_, sizeof(a_));	\
+		memcpy(&b_, (in) + 16 * (lanes) * i_ + sizeof(a_),	\
+		    sizeof(b_));					\
+		lo_ = __builtin_shufflevector(a_, b_, LO);		\
+		hi_ = __builtin_shufflevector(a_, b_, HI);		\
+		CT_INTERLEAVE_IN(word, (q)[i_], (q)[i_ + 4],		\
+		    lo_ & 0xFFFFFFFFULL, lo_ >> 32,			\
+		    hi_ & 0xFFFFFFFFULL, hi_ >> 32);			\
+	}								\
+	CT_ORTHO(word, q);						\
+} while (0)
+
+/* The inverse of CT_LOAD(); A and B zip the halves back together. */
+#define	CT_STORE(word, lanes, q, out, A, B) do {			\
+	word w_[4], a_, b_, lo_, hi_;					\
+	int i_;								\
+									\
+	CT_ORTHO(word, q);						\
+	for (i_ = 0; i_ < 4; i_++) {					\
+		CT_INTERLEAVE_OUT(word, w_, (q)[i_], (q)[i_ + 4]);	\
+		lo_ = w_[0] | (w_[1] << 32);				\
+		hi_ = w_[2] | (w_[3] << 32);				\
+		a_ = __builtin_shufflevector(lo_, hi_, A);		\
+		b_ = __builtin_shufflevector(lo_, hi_, B);		\
+		memcpy((out) + 16 * (lanes) * i_, &a_, sizeof(a_));	\
+		memcpy((out) + 16 * (lanes) * i_ + sizeof(a_), &b_,	\
+		    sizeof(b_));					\
+	}								\
+} while (0)
+
+/*
+ * The loads and stores must be inlined into ct_batches_avx2() to be
+ * built for AVX2.
+ */
+#define	CT_INLINE	inline __attribute__((__always_inline__))
+
+/* Shuffles for CT_LOAD() and CT_STORE(); with two lanes they coincide. */
+#define	CT_LO2		0, 2
+#define	CT_HI2		1, 3
+#define	CT_LO4		0, 2, 4, 6
+#define	CT_HI4		1, 3, 5, 7
+#define	CT_ZIPLO4	0, 4, 1, 5
+#define	CT_ZIPHI4	2, 6, 3, 7
+
+#ifdef CT_VECTOR
+static CT_INLINE void
+ct_load2(ct_v2 q[8], const u8 *in)
+{
+	CT_LOAD(ct_v2, 2, q, in, CT_LO2, CT_HI2);
+}
+
+static CT_INLINE void
+ct_store2(ct_v2 q[8], u8 *out)
+{
+	CT_STORE(ct_v2, 2, q, out, CT_LO2, CT_HI2);
+}
+#endif
+
+#ifdef CT_AVX2
+static CT_INLINE void
+ct_load4(ct_v4 q[8], const u8 *in)
+{
+	CT_LOAD(ct_v4, 4, q, in, CT_LO4, CT_HI4);
+}
+
+static CT_INLINE void
+ct_store4(ct_v4 q[8], u8 *out)
+{
+	CT_STORE(ct_v4, 4, q, out, CT_ZIPLO4, CT_ZIPHI4);
+}
+#endif
+
+#ifndef CT_VECTOR
+/* Without vectors, and in the kernel, a lane of four blocks at a time. */
+static CT_INLINE void
+ct_load1(uint64_t q[8], const u8 *in)
+{
+	int i;
+
+	for (i = 0; i < 4; i++)
+		CT_INTERLEAVE_IN(uint64_t, q[i], q[i + 4],
+		    CT_DEC32LE(in + 16 * i), CT_DEC32LE(in + 16 * i + 4),
+		    CT_DEC32LE(in + 16 * i + 8), CT_DEC32LE(in + 16 * i + 12));
+	CT_ORTHO(uint64_t, q);
+}
+
+static CT_INLINE void
+ct_store1(uint64_t q[8], u8 *out)
+{
+	uint64_t w[4];
+	u8 *p;
+	int i, k;
+
+	CT_ORTHO(uint64_t, q);
+	for (i = 0; i < 4; i++) {
+		CT_INTERLEAVE_OUT(uint64_t, w, q[i], q[i + 4]);
+		p = out + 16 * i;
+		for (k = 0; k < 4; k++) {
+			p[4 * k    ] = (u8)w[k];
+			p[4 * k + 1] = (u8)(w[k] >> 8);
+			p[4 * k + 2] = (u8)(w[k] >> 16);
+			p[4 * k + 3] = (u8)(w[k] >> 24);
+		}
+	}
+}
+#endif
+
+/*
+ * Bitslice each round key into a single lane; it is the same for every
+ * block, and ct_batches() copies it to all the lanes.
+ */
+static void
+ct_load_keys(uint64_t sk[][8], const u32 *rk, int Nr)
+{
+	uint64_t *q;
+	u32 w[4], x;
+	int k, r;
+
+	for (r = 0; r <= Nr; r++) {
+		for (k = 0; k < 4; k++) {
+			/* rk holds the key bytes big-endian */
+			x = rk[4 * r + k];
+			w[k] = (x >> 24) | ((x >> 8) & 0xff00) |
+			    ((x << 8) & 0xff0000) | (x << 24);
+		}
+		q = sk[r];
+		CT_INTERLEAVE_IN(uint64_t, q[0], q[4], w[0], w[1], w[2], w[3]);
+		q[1] = q[2] = q[3] = q[0];
+		q[5] = q[6] = q[7] = q[4];
+		CT_ORTHO(uint64_t, q);
+	}
+	explicit_bzero(w, sizeof(w));
+}
+
+/*
+ * One block.  Plane q[b] has bit b of state byte 4 * column + row at
+ * that bit of both 16-bit halves.
+ */
+static void
+ct1_sbox(u32 q[8])
+{
+	CT_SBOX(u32, q);
+}
+
+#define	CT1_ROTR(x, n)	(((x) >> (n)) | ((x) << (32 - (n))))
+/* each row takes the next one's bits, and the last the first's */
+#define	CT1_ROW1(x)	((((x) >> 1) & 0x77777777U) | (((x) << 3) & 0x88888888U))
+#define	CT1_ROW2(x)	((((x) >> 2) & 0x33333333U) | (((x) << 2) & 0xccccccccU))
+
+/* Row r moves r columns left, rotating its bits right by 4 * r. */
+static inline void
+ct1_shift_rows(u32 q[8])
+{
+	u32 x;
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		x = q[i];
+		q[i] = (x & 0x11111111U) | CT1_ROTR(x & 0x22222222U, 4) |
+		    CT1_ROTR(x & 0x44444444U, 8) |
+		    CT1_ROTR(x & 0x88888888U, 12);
+	}
+}
+
+static inline void
+ct1_mix_columns(u32 q[8])
+{
+	CT_MIX_COLUMNS(u32, q, CT1_ROW1, CT1_ROW2);
+}
+
+/*
+ * Transpose the 8x8 bit matrix in x whose rows are its bytes: bit j of
+ * byte k becomes bit k of byte j.
+ */
+static inline uint64_t
+ct1_transpose(uint64_t x)
+{
+	uint64_t t;
+
+	t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+	x ^= t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+	x ^= t ^ (t << 14);
+	t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+	x ^= t ^ (t << 28);
+	return (x);
+}
+
+static void
+ct1_load(u32 q[8], const u8 in[16])
+{
+	uint64_t lo, hi;
+	u32 v;
+	int b;
+
+	lo = (uint64_t)CT_DEC32LE(in + 4) << 32 | CT_DEC32LE(in);
+	hi = (uint64_t)CT_DEC32LE(in + 12) << 32 | CT_DEC32LE(in + 8);
+	lo = ct1_transpose(lo);
+	hi = ct1_transpose(hi);
+	for (b = 0; b < 8; b++) {
+		v = (u32)(lo >> (8 * b)) & 0xff;
+		v |= ((u32)(hi >> (8 * b)) & 0xff) << 8;
+		q[b] = v | v << 16;
+	}
+}
+
+static void
+ct1_store(const u32 q[8], u8 out[16])
+{
+	uint64_t lo, hi;
+	int b, k;
+
+	lo = hi = 0;
+	for (b = 0; b < 8; b++) {
+		lo |= (uint64_t)(q[b] & 0xff) << (8 * b);
+		hi |= (uint64_t)((q[b] >> 8) & 0xff) << (8 * b);
+	}
+	lo = ct1_transpose(lo);
+	hi = ct1_transpose(hi);
+	for (k = 0; k < 8; k++) {
+		out[k] = (u8)(lo >> (8 * k));
+		out[8 + k] = (u8)(hi >> (8 * k));
+	}
+}
+
+static void
+ct1_load_keys(u32 sk[][8], const u32 *rk, int Nr)
+{
+	u8 key[16];
+	int i, r;
+
+	for (r = 0; r <= Nr; r++) {
+		for (i = 0; i < 4; i++) {
+			key[4 * i    ] = (u8)(rk[4 * r + i] >> 24);
+			key[4 * i + 1] = (u8)(rk[4 * r + i] >> 16);
+			key[4 * i + 2] = (u8)(rk[4 * r + i] >>  8);
+			key[4 * i + 3] = (u8)(rk[4 * r + i]);
+		}
+		ct1_load(sk[r], key);
+	}
+	explicit_bzero(key, sizeof(key));
+}
+
+static void
+ct1_encrypt(u32 sk[][8], int Nr, u32 q[8])
+{
+	int r;
+
+	CT_ADD_ROUND_KEY(q, sk[0]);
+	for (r = 1; r < Nr; r++) {
+		ct1_sbox(q);
+		ct1_shift_rows(q);
+		ct1_mix_columns(q);
+		CT_ADD_ROUND_KEY(q, sk[r]);
+	}
+	ct1_sbox(q);
+	ct1_shift_rows(q);
+	CT_ADD_ROUND_KEY(q, sk[Nr]);
+}
+
+/* SubBytes on each byte of a key schedule word. */
+static u32
+ct_sub_word(u32 x)
+{
+	u32 q[8], y;
+	int b, i;
+
+	/* bit i of plane b is bit b of byte i */
+	for (b = 0; b < 8; b++) {
+		q[b] = 0;
+		for (i = 0; i < 4; i++)
+			q[b] |= ((x >> (8 * i + b)) & 1) << i;
+	}
+	ct1_sbox(q);
+	y = 0;
+	for (b = 0; b < 8; b++)
+		for (i = 0; i < 4; i++)
+			y |= ((q[b] >> i) & 1) << (8 * i + b);
+	explicit_bzero(q, sizeof(q));
+	return (y);
+}
+
+/* InvMixColumns on one key schedule word, four GF(2^8) bytes at once. */
+static u32
+ct_inv_mix_word(u32 x)
+{
+	u32 x2, x4, x8;
+
+#define	CT_XTIME4(v)	((((v) & 0x7f7f7f7fU) << 1) ^ \
+	    ((((v) >> 7) & 0x01010101U) * 0x1b))
+	x2 = CT_XTIME4(x);
+	x4 = CT_XTIME4(x2);
+	x8 = CT_XTIME4(x4);
+#undef CT_XTIME4
+#define	CT_ROTL(v, n)	(((v) << (n)) | ((v) >> (32 - (n))))
+	/* 14 * a[i] ^ 11 * a[i+1] ^ 13 * a[i+2] ^ 9 * a[i+3] */
+	return ((x8 ^ x4 ^ x2) ^ CT_ROTL(x8 ^ x2 ^ x, 8) ^
+	    CT_ROTL(x8 ^ x4 ^ x, 16) ^ CT_ROTL(x8 ^ x, 24));
+#undef CT_ROTL
+}
+
+/* Encrypt with the one-block form; CBC and single blocks use this. */
+static void
+ct1_ecb(const u32 *rk, int Nr, const u8 *in, u8 *out, size_t nblocks,
+    const u8 *iv)
+{
+	u32 sk[RIJNDAEL_MAXNR + 1][8], q[8];
+	u8 block[16];
+	int i;
+
+	ct1_load_keys(sk, rk, Nr);
+	for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+		for (i = 0; i < 16; i++)
+			block[i] = iv != NULL ? in[i] ^ iv[i] : in[i];
+		ct1_load(q, block);
+		ct1_encrypt(sk, Nr, q);
+		ct1_store(q, out);
+		if (iv != NULL)
+			iv = out;
+	}
+	explicit_bzero(sk, sizeof(sk));
+	explicit_bzero(q, sizeof(q));
+	explicit_bzero(block, sizeof(block));
+}
+
+/*
+ * Define a function that encrypts or decrypts nblocks blocks, 4 * lanes
+ * at a time in vectors of type word, with the round keys sk from
+ * ct_load_keys().  A short last batch goes through a zero-padded copy.
+ */
+#define	CT_BATCHES(name, word, lanes, load, store, attr)		\
+static attr void							\
+name(const uint64_t sk[][8], int Nr, const u8 *in, u8 *out,		\
+    size_t nblocks, int decrypt)					\
+{									\
+	word k[RIJNDAEL_MAXNR + 1][8], q[8];				\
+	u8 buf[64 * (lanes)];						\
+	size_t n;							\
+	int i, r;							\
+									\
+	for (r = 0; r <= Nr; r++)					\
+		for (i = 0; i < 8; i++)					\
+			k[r][i] = (word){ 0 } + sk[r][i];		\
+	for (; nblocks > 0; nblocks -= n, in += 16 * n, out += 16 * n) { \
+		n = nblocks < 4 * (lanes) ? nblocks : 4 * (lanes);	\
+		if (n < 4 * (lanes)) {					\
+			memset(buf, 0, sizeof(buf));			\
+			memcpy(buf, in, 16 * n);			\
+			load(q, buf);					\
+		} else							\
+			load(q, in);					\
+		if (decrypt)						\
+			CT_DECRYPT(word, k, Nr, q);			\
+		else							\
+			CT_ENCRYPT(word, k, Nr, q);			\
+		if (n < 4 * (lanes)) {					\
+			store(q, buf);					\
+			memcpy(out, buf, 16 * n);			\
+		} else							\
+			store(q, out);					\
+	}								\
+	explicit_bzero(k, sizeof(k));					\
+	explicit_bzero(q, sizeof(q));					\
+	explicit_bzero(buf, sizeof(buf));				\
+}
+
+#ifdef CT_VECTOR
+CT_BATCHES(ct_batches, ct_v2, 2, ct_load2, ct_store2, )
+#else
+CT_BATCHES(ct_batches, uint64_t, 1, ct_load1, ct_store1, )
+#endif
+#ifdef CT_AVX2
+CT_BATCHES(ct_batches_avx2, ct_v4, 4, ct_load4, ct_store4,
+    __attribute__((target("avx2"))))
+
+/* 1 if the CPU and OS support AVX2, else 0. */
+static int
+ct_have_avx2(void)
+{
+
+	return (hw_x86_avx_level() >= HW_X86_AVX2);
+}
+#endif
+
+typedef void ct_batches_fn(const uint64_t [][8], int, const u8 *, u8 *,
+    size_t, int);
+
+/* The widest variant the CPU has, probed once. */
+static ct_batches_fn *
+ct_select(void)
+{
+#ifdef CT_AVX2
+	if (HW_PROBE_ONCE(ct_have_avx2))
+		return (ct_batches_avx2);
+#endif
+	return (ct_batches);
+}
+
+/* A lone block to be encrypted goes through the one-block form. */
+static void
+ct_ecb(const u32 *rk, int Nr, const u8 *in, u8 *out, size_t nblocks,
+    int decrypt)
+{
+	uint64_t sk[RIJNDAEL_MAXNR + 1][8];
+
+	if (!decrypt && nblocks == 1) {
+		ct1_ecb(rk, Nr, in, out, 1, NULL);
+		return;
+	}
+	ct_load_keys(sk, rk, Nr);
+	ct_select()(sk, Nr, in, out, nblocks, decrypt);
+	explicit_bzero(sk, sizeof(sk));
+}
+
+/* CBC encryption is serial, one block at a time. */
+static void
+ct_cbc_encrypt(const u32 *rk, int Nr, const u8 iv[16], const u8 *in,
+    u8 *out, size_t nblocks)
+{
+	ct1_ecb(rk, Nr, in, out, nblocks, iv);
+}
+
+static void
+ct_cbc_decrypt(const u32 *rk, int Nr, const u8 iv[16], const u8 *in,
+    u8 *out, size_t nblocks)
+{
+	uint64_t sk[RIJNDAEL_MAXNR + 1][8];
+	u8 c[16 * (CT_BLOCKS + 1)], p[16 * CT_BLOCKS];
+	ct_batches_fn *batches;
+	size_t i, n;
+
+	batches = ct_select();
+	ct_load_keys(sk, rk, Nr);
+	/* c holds the previous ciphertext block, then this batch's */
+	memcpy(c, iv, 16);
+	for (; nblocks > 0; nblocks -= n, in += 16 * n, out += 16 * n) {
+		n = nblocks < CT_BLOCKS ? nblocks : CT_BLOCKS;
+		memcpy(c + 16, in, 16 * n);
+		batches(sk, Nr, c + 16, p, n, 1);
+		for (i = 0; i < 16 * n; i++)
+			out[i] = p[i] ^ c[i];
+		memcpy(c, c + 16 * n, 16);
+	}
+	explicit_bzero(sk, sizeof(sk));
+	explicit_bzero(p, sizeof(p));
+}
+
+/* The counter blocks are built up CT_BLOCKS at a time. */
+static void
+ct_ctr(const u32 *rk, int Nr, uint64_t ctr[2], const u8 *in, u8 *out,
+    size_t nblocks)
+{
+	uint64_t sk[RIJNDAEL_MAXNR + 1][8];
+	u8 ks[16 * CT_BLOCKS];
+	ct_batches_fn *batches;
+	size_t i, n;
+	int j;
+
+	batches = ct_select();
+	ct_load_keys(sk, rk, Nr);
+	for (; nblocks > 0; nblocks -= n, in += 16 * n, out += 16 * n) {
+		n = nblocks < CT_BLOCKS ? nblocks : CT_BLOCKS;
+		for (i = 0; i < n; i++) {
+			for (j = 0; j < 8; j++) {
+				ks[16 * i + j] = (u8)(ctr[0] >> (56 - 8 * j));
+				ks[16 * i + 8 + j] =
+				    (u8)(ctr[1] >> (56 - 8 * j));
+			}
+			if (++ctr[1] == 0)
+				ctr[0]++;
+		}
+		batches(sk, Nr, ks, ks, n, 0);
+		for (i = 0; i < 16 * n; i++)
+			out[i] = in[i] ^ ks[i];
+	}
+	explicit_bzero(sk, sizeof(sk));
+	explicit_bzero(ks, sizeof(ks));
+}
+
+#endif /* _RIJNDAEL_CT_H_ */
@@ -0,0 +1,805 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * AES round instructions for rijndael-alg-fst.c: AES-NI on x86 and the
+ * ARMv8 Cryptography Extensions on AArch64, picked at run time when the
+ * CPU has them.  Besides being much faster than the T-tables, they take
+ * the same time for every key and input, which table lookups do not.
+ *
+ * The key schedules are the ones rijndaelKeySetupEnc() and
+ * rijndaelKeySetupDec() build, with each word holding four key bytes
+ * big-endian; rijndael_hw_keys() turns them into 16-byte round keys.
+ * The decryption schedule is already in the form the "equivalent inverse
+ * cipher" needs (reversed, with InvMixColumns applied to the inner round
+ * keys), which is what AESDEC and AESD/AESIMC expect.
+ *
+ * Only userland uses this; the kernel must not touch vector registers
+ * here, so _KERNEL builds keep to the T-tables.
+ */
+
+#ifndef _RIJNDAEL_HW_H_
+#define	_RIJNDAEL_HW_H_
+
+#if !defined(_KERNEL) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#define	RIJNDAEL_AESNI	1
+#elif !defined(_KERNEL) && defined(__aarch64__) && defined(__linux__) && \
+    defined(__AARCH64EL__) && (defined(__ARM_FEATURE_AES) || \
+    defined(__ARM_FEATURE_CRYPTO) || !defined(__clang__) || \
+    __clang_major__ >= 16)
+/* Older clang only declares the AES intrinsics when built for them. */
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_AES
+#define	HWCAP_AES	(1 << 3)
+#endif
+#define	RIJNDAEL_ARMV8CE	1
+#endif
+
+#if defined(RIJNDAEL_AESNI) || defined(RIJNDAEL_ARMV8CE)
+#define	RIJNDAEL_HW	1
+
+#include <sys/hw_probe.h>
+
+static void
+rijndael_hw_keys(const u32 *rk, int Nr, u8 keys[][16])
+{
+	int i;
+
+	for (i = 0; i < 4 * (Nr + 1); i++) {
+		keys[i / 4][4 * (i % 4)    ] = (u8)(rk[i] >> 24);
+		keys[i / 4][4 * (i % 4) + 1] = (u8)(rk[i] >> 16);
+		keys[i / 4][4 * (i % 4) + 2] = (u8)(rk[i] >>  8);
+		keys[i / 4][4 * (i % 4) + 3] = (u8)(rk[i]);
+	}
+}
+
+/* CTR counter blocks are a 128-bit big-endian integer, as ctr[0], ctr[1]. */
+#define	AES_CTR_INC(hi, lo) do {					\
+	if (++(lo) == 0)						\
+		(hi)++;							\
+} while (0)
+
+/* XTS tweaks are little-endian, as tweak[0] (low), tweak[1]; times x. */
+#define	AES_XTS_MUL(hi, lo) do {					\
+	uint64_t c_ = (0 - ((hi) >> 63)) & 0x87;			\
+	(hi) = (hi) << 1 | (lo) >> 63;					\
+	(lo) = (lo) << 1 ^ c_;						\
+} while (0)
+
+#ifdef RIJNDAEL_AESNI
+#define	RIJNDAEL_TARGET	__attribute__((target("aes,sse2")))
+
+static int
+rijndael_hw_probe(void)
+{
+	unsigned int eax, ebx, ecx, edx;
+
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		return (0);
+	return ((ecx & bit_AES) != 0 && (edx & bit_SSE2) != 0);
+}
+
+#define	AES_LOADKEYS(k, keys, Nr) do {					\
+	int r_;								\
+	for (r_ = 0; r_ <= (Nr); r_++)					\
+		(k)[r_] = _mm_loadu_si128((const __m128i *)(keys)[r_]);	\
+} while (0)
+
+#define	AES_CTR_BLOCK(hi, lo)						\
+	_mm_set_epi64x((long long)__builtin_bswap64(lo),		\
+	    (long long)__builtin_bswap64(hi))
+
+#define	AES_XTS_BLOCK(hi, lo)	_mm_set_epi64x((long long)(hi), (long long)(lo))
+
+RIJNDAEL_TARGET static void
+rijndael_hw_encrypt(const u32 *rk, int Nr, const u8 *in, u8 *out,
+    size_t nblocks)
+{
+	u8 keys[RIJNDAEL_MAXNR + 1][16];
+	__m128i k[RIJNDAEL_MAXNR + 1], s[4];
+	int r;
+
+	rijndael_hw_keys(rk, Nr, keys);
+	AES_LOADKEYS(k, keys, Nr);
+	for (; nblocks >= 4; nblocks -= 4, in += 64, out += 64) {
+		s[0] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in),
+		    k[0]);
+		s[1] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + 1),
+		    k[0]);
+		s[2] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + 2),
+		    k[0]);
+		s[3] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + 3),
+		    k[0]);
+		for (r = 1; r < Nr; r++) {
+			s[0] = _mm_aesenc_si128(s[0], k[r]);
+			s[1] = _mm_aesenc_si128(s[1], k[r]);
+			s[2] = _mm_aesenc_si128(s[2], k[r]);
+			s[3] = _mm_aesenc_si128(s[3], k[r]);
+		}
+		_mm_storeu_si128((__m128i *)out,
+		    _mm_aesenclast_si128(s[0], k[Nr]));
+		_mm_storeu_si128((__m128i *)out + 1,
+		    _mm_aesenclast_si128(s[1], k[Nr]));
+		_mm_storeu_si128((__m128i *)out + 2,
+		    _mm_aesenclast_si128(s[2], k[Nr]));
+		_mm_storeu_si128((__m128i *)out + 3,
+		    _mm_aesenclast_si128(s[3], k[Nr]));
+	}
+	for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+		s[0] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in),
+		    k[0]);
+		for (r = 1; r < Nr; r++)
+			s[0] = _mm_aesenc_si128(s[0], k[r]);
+		_mm_storeu_si128((__m128i *)out,
+		    _mm_aesenclast_si128(s[0], k[Nr]));
+	}
+	explicit_bzero(keys, sizeof(keys));
+	explicit_bzero(k, sizeof(k));
+}
+
+RIJNDAEL_TARGET static void
+rijndael_hw_decrypt(const u32 *rk, int Nr, const u8 *in, u8 *out,
+    size_t nblocks)
+{
+	u8 keys[RIJNDAEL_MAXNR + 1][16];
+	__m128i k[RIJNDAEL_MAXNR + 1], s[4];
+	int r;
+
+	rijndael_hw_keys(rk, Nr, keys);
+	AES_LOADKEYS(k, keys, Nr);
+	for (; nblocks >= 4; nblocks -= 4, in += 64, out += 64) {
+		s[0] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in),
+		    k[0]);
+		s[1] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + 1),
+		    k[0]);
+		s[2] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + 2),
+		    k[0]);
+		s[3] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + 3),
+		    k[0]);
+		for (r = 1; r < Nr; r++) {
+			s[0] = _mm_aesdec_si128(s[0], k[r]);
+			s[1] = _mm_aesdec_si128(s[1], k[r]);
+			s[2] = _mm_aesdec_si128(s[2], k[r]);
+			s[3] = _mm_aesdec_si128(s[3], k[r]);
+		}
+		_mm_storeu_si128((__m128i *)out,
+		    _mm_aesdeclast_si128(s[0], k[Nr]));
+		_mm_storeu_si128((__m128i *)out + 1,
+		    _mm_aesdeclast_si128(s[1], k[Nr]));
+		_mm_storeu_si128((__m128i *)out + 2,
+		    _mm_aesdeclast_si128(s[2], k[Nr]));
+		_mm_storeu_si128((__m128i *)out + 3,
+		    _mm_aesdeclast_si128(s[3], k[Nr]));
+	}
+	for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+		s[0] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in),
+		    k[0]);
+		for (r = 1; r < Nr; r++)
+			s[0] = _mm_aesdec_si128(s[0], k[r]);
+		_mm_storeu_si128((__m128i *)out,
+		    _mm_aesdeclast_si128(s[0], k[Nr]));
+	}
+	explicit_bzero(keys, sizeof(keys));
+	explicit_bzero(k, sizeof(k));
+}
+
+RIJNDAEL_TARGET static void
+rijndael_hw_cbc_encrypt(const u32 *rk, int Nr, const u8 iv[16],
+    const u8 *in, u8 *out, size_t nblocks)
+{
+	u8 keys[RIJNDAEL_MAXNR + 1][16];
+	__m128i k[RIJNDAEL_MAXNR + 1], s;
+	int r;
+
+	rijndael_hw_keys(rk, Nr, keys);
+	AES_LOADKEYS(k, keys, Nr);
+	s = _mm_loadu_si128((const __m128i *)iv);
+	for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+		s = _mm_xor_si128(s, _mm_loadu_si128((const __m128i *)in));
+		s = _mm_xor_si128(s, k[0]);
+		for (r = 1; r < Nr; r++)
+			s = _mm_aesenc_si128(s, k[r]);
+		s = _mm_aesenclast_si128(s, k[Nr]);
+		_mm_storeu_si128((__m128i *)out, s);
+	}
+	explicit_bzero(keys, sizeof(keys));
+	explicit_bzero(k, sizeof(k));
+}
+
+RIJNDAEL_TARGET static void
+rijndael_hw_cbc_decrypt(const u32 *rk, int Nr, const u8 iv[16],
+    const u8 *in, u8 *out, size_t nblocks)
+{
+	u8 keys[RIJNDAEL_MAXNR + 1][16];
+	__m128i k[RIJNDAEL_MAXNR + 1], c[4], prev, s[4];
+	int r;
+
+	rijndael_hw_keys(rk, Nr, keys);
+	AES_LOADKEYS(k, keys, Nr);
+	prev = _mm_loadu_si128((const __m128i *)iv);
+	/* Unlike encryption the blocks are independent until the XOR. */
+	for (; nblocks >= 4; nblocks -= 4, in += 64, out += 64) {
+		c[0] = _mm_loadu_si128((const __m128i *)in);
+		c[1] = _mm_loadu_si128((const __m128i *)in + 1);
+		c[2] = _mm_loadu_si128((const __m128i *)in + 2);
+		c[3] = _mm_loadu_si128((const __m128i *)in + 3);
+		s[0] = _mm_xor_si128(c[0], k[0]);
+		s[1] = _mm_xor_si128(c[1], k[0]);
+		s[2] = _mm_xor_si128(c[2], k[0]);
+		s[3] = _mm_xor_si128(c[3], k[0]);
+		for (r = 1; r < Nr; r++) {
+			s[0] = _mm_aesdec_si128(s[0], k[r]);
+			s[1] = _mm_aesdec_si128(s[1], k[r]);
+			s[2] = _mm_aesdec_si128(s[2], k[r]);
+			s[3] = _mm_aesdec_si128(s[3], k[r]);
+		}
+		s[0] = _mm_aesdeclast_si128(s[0], k[Nr]);
+		s[1] = _mm_aesdeclast_si128(s[1], k[Nr]);
+		s[2] = _mm_aesdeclast_si128(s[2], k[Nr]);
+		s[3] = _mm_aesdeclast_si128(s[3], k[Nr]);
+		_mm_storeu_si128((__m128i *)out, _mm_xor_si128(s[0], prev));
+		_mm_storeu_si128((__m128i *)out + 1, _mm_xor_si128(s[1], c[0]));
+		_mm_storeu_si128((__m128i *)out + 2, _mm_xor_si128(s[2], c[1]));
+		_mm_storeu_si128((__m128i *)out + 3, _mm_xor_si128(s[3], c[2]));
+		prev = c[3];
+	}
+	for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+		c[0] = _mm_loadu_si128((const __m128i *)in);
+		s[0] = _mm_xor_si128(c[0], k[0]);
+		for (r = 1; r < Nr; r++)
+			s[0] = _mm_aesdec_si128(s[0], k[r]);
+		s[0] = _mm_aesdeclast_si128(s[0], k[Nr]);
+		_mm_storeu_si128((__m128i *)out, _mm_xor_si128(s[0], prev));
+		prev = c[0];
+	}
+	explicit_bzero(keys, sizeof(keys));
+	explicit_bzero(k, sizeof(k));
+}
+
+RIJNDAEL_TARGET static void
+rijndael_hw_ctr(const u32 *rk, int Nr, uint64_t ctr[2], const u8 *in,
+    u8 *out, size_t nblocks)
+{
+	u8 keys[RIJNDAEL_MAXNR + 1][16];
+	__m128i k[RIJNDAEL_MAXNR + 1], s[4];
+	uint64_t hi, lo;
+	int r;
+
+	rijndael_hw_keys(rk, Nr, keys);
+	AES_LOADKEYS(k, keys, Nr);
+	hi = ctr[0];
+	lo = ctr[1];
+	for (; nblocks >= 4; nblocks -= 4, in += 64, out += 64) {
+		s[0] = _mm_xor_si128(AES_CTR_BLOCK(hi, lo), k[0]);
+		AES_CTR_INC(hi, lo);
+		s[1] = _mm_xor_si128(AES_CTR_BLOCK(hi, lo), k[0]);
+		AES_CTR_INC(hi, lo);
+		s[2] = _mm_xor_si128(AES_CTR_BLOCK(hi, lo), k[0]);
+		AES_CTR_INC(hi, lo);
+		s[3] = _mm_xor_si128(AES_CTR_BLOCK(hi, lo), k[0]);
+		AES_CTR_INC(hi, lo);
+		for (r = 1; r < Nr; r++) {
+			s[0] = _mm_aesenc_si128(s[0], k[r]);
+			s[1] = _mm_aesenc_si128(s[1], k[r]);
+			s[2] = _mm_aesenc_si128(s[2], k[r]);
+			s[3] = _mm_aesenc_si128(s[3], k[r]);
+		}
+		s[0] = _mm_aesenclast_si128(s[0], k[Nr]);
+		s[1] = _mm_aesenclast_si128(s[1], k[Nr]);
+		s[2] = _mm_aesenclast_si128(s[2], k[Nr]);
+		s[3] = _mm_aesenclast_si128(s[3], k[Nr]);
+		_mm_storeu_si128((__m128i *)out, _mm_xor_si128(s[0],
+		    _mm_loadu_si128((const __m128i *)in)));
+		_mm_storeu_si128((__m128i *)out + 1, _mm_xor_si128(s[1],
+		    _mm_loadu_si128((const __m128i *)in + 1)));
+		_mm_storeu_si128((__m128i *)out + 2, _mm_xor_si128(s[2],
+		    _mm_loadu_si128((const __m128i *)in + 2)));
+		_mm_storeu_si128((__m128i *)out + 3, _mm_xor_si128(s[3],
+		    _mm_loadu_si128((const __m128i *)in + 3)));
+	}
+	for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+		s[0] = _mm_xor_si128(AES_CTR_BLOCK(hi, lo), k[0]);
+		AES_CTR_INC(hi, lo);
+		for (r = 1; r < Nr; r++)
+			s[0] = _mm_aesenc_si128(s[0], k[r]);
+		s[0] = _mm_aesenclast_si128(s[0], k[Nr]);
+		_mm_storeu_si128((__m128i *)out, _mm_xor_si128(s[0],
+		    _mm_loadu_si128((const __m128i *)in)));
+	}
+	ctr[0] = hi;
+	ctr[1] = lo;
+	explicit_bzero(keys, sizeof(keys));
+	explicit_bzero(k, sizeof(k));
+}
+
+RIJNDAEL_TARGET static void
+rijndael_hw_xts_encrypt(const u32 *rk, int Nr, const u8 tweak[16],
+    const u8 *in, u8 *out, size_t nblocks)
+{
+	u8 keys[RIJNDAEL_MAXNR + 1][16];
+	__m128i k[RIJNDAEL_MAXNR + 1], s[4], t[4];
+	uint64_t hi, lo;
+	int r;
+
+	rijndael_hw_keys(rk, Nr, keys);
+	AES_LOADKEYS(k, keys, Nr);
+	memcpy(&lo, tweak, 8);
+	memcpy(&hi, tweak + 8, 8);
+	for (; nblocks >= 4; nblocks -= 4, in += 64, out += 64) {
+		t[0] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		t[1] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		t[2] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		t[3] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		s[0] = _mm_xor_si128(_mm_xor_si128(t[0],
+		    _mm_loadu_si128((const __m128i *)in)), k[0]);
+		s[1] = _mm_xor_si128(_mm_xor_si128(t[1],
+		    _mm_loadu_si128((const __m128i *)in + 1)), k[0]);
+		s[2] = _mm_xor_si128(_mm_xor_si128(t[2],
+		    _mm_loadu_si128((const __m128i *)in + 2)), k[0]);
+		s[3] = _mm_xor_si128(_mm_xor_si128(t[3],
+		    _mm_loadu_si128((const __m128i *)in + 3)), k[0]);
+		for (r = 1; r < Nr; r++) {
+			s[0] = _mm_aesenc_si128(s[0], k[r]);
+			s[1] = _mm_aesenc_si128(s[1], k[r]);
+			s[2] = _mm_aesenc_si128(s[2], k[r]);
+			s[3] = _mm_aesenc_si128(s[3], k[r]);
+		}
+		_mm_storeu_si128((__m128i *)out,
+		    _mm_xor_si128(_mm_aesenclast_si128(s[0], k[Nr]), t[0]));
+		_mm_storeu_si128((__m128i *)out + 1,
+		    _mm_xor_si128(_mm_aesenclast_si128(s[1], k[Nr]), t[1]));
+		_mm_storeu_si128((__m128i *)out + 2,
+		    _mm_xor_si128(_mm_aesenclast_si128(s[2], k[Nr]), t[2]));
+		_mm_storeu_si128((__m128i *)out + 3,
+		    _mm_xor_si128(_mm_aesenclast_si128(s[3], k[Nr]), t[3]));
+	}
+	for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+		t[0] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		s[0] = _mm_xor_si128(_mm_xor_si128(t[0],
+		    _mm_loadu_si128((const __m128i *)in)), k[0]);
+		for (r = 1; r < Nr; r++)
+			s[0] = _mm_aesenc_si128(s[0], k[r]);
+		_mm_storeu_si128((__m128i *)out,
+		    _mm_xor_si128(_mm_aesenclast_si128(s[0], k[Nr]), t[0]));
+	}
+	explicit_bzero(keys, sizeof(keys));
+	explicit_bzero(k, sizeof(k));
+}
+
+RIJNDAEL_TARGET static void
+rijndael_hw_xts_decrypt(const u32 *rk, int Nr, const u8 tweak[16],
+    const u8 *in, u8 *out, size_t nblocks)
+{
+	u8 keys[RIJNDAEL_MAXNR + 1][16];
+	__m128i k[RIJNDAEL_MAXNR + 1], s[4], t[4];
+	uint64_t hi, lo;
+	int r;
+
+	rijndael_hw_keys(rk, Nr, keys);
+	AES_LOADKEYS(k, keys, Nr);
+	memcpy(&lo, tweak, 8);
+	memcpy(&hi, tweak + 8, 8);
+	for (; nblocks >= 4; nblocks -= 4, in += 64, out += 64) {
+		t[0] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		t[1] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		t[2] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		t[3] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		s[0] = _mm_xor_si128(_mm_xor_si128(t[0],
+		    _mm_loadu_si128((const __m128i *)in)), k[0]);
+		s[1] = _mm_xor_si128(_mm_xor_si128(t[1],
+		    _mm_loadu_si128((const __m128i *)in + 1)), k[0]);
+		s[2] = _mm_xor_si128(_mm_xor_si128(t[2],
+		    _mm_loadu_si128((const __m128i *)in + 2)), k[0]);
+		s[3] = _mm_xor_si128(_mm_xor_si128(t[3],
+		    _mm_loadu_si128((const __m128i *)in + 3)), k[0]);
+		for (r = 1; r < Nr; r++) {
+			s[0] = _mm_aesdec_si128(s[0], k[r]);
+			s[1] = _mm_aesdec_si128(s[1], k[r]);
+			s[2] = _mm_aesdec_si128(s[2], k[r]);
+			s[3] = _mm_aesdec_si128(s[3], k[r]);
+		}
+		_mm_storeu_si128((__m128i *)out,
+		    _mm_xor_si128(_mm_aesdeclast_si128(s[0], k[Nr]), t[0]));
+		_mm_storeu_si128((__m128i *)out + 1,
+		    _mm_xor_si128(_mm_aesdeclast_si128(s[1], k[Nr]), t[1]));
+		_mm_storeu_si128((__m128i *)out + 2,
+		    _mm_xor_si128(_mm_aesdeclast_si128(s[2], k[Nr]), t[2]));
+		_mm_storeu_si128((__m128i *)out + 3,
+		    _mm_xor_si128(_mm_aesdeclast_si128(s[3], k[Nr]), t[3]));
+	}
+	for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+		t[0] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		s[0] = _mm_xor_si128(_mm_xor_si128(t[0],
+		    _mm_loadu_si128((const __m128i *)in)), k[0]);
+		for (r = 1; r < Nr; r++)
+			s[0] = _mm_aesdec_si128(s[0], k[r]);
+		_mm_storeu_si128((__m128i *)out,
+		    _mm_xor_si128(_mm_aesdeclast_si128(s[0], k[Nr]), t[0]));
+	}
+	explicit_bzero(keys, sizeof(keys));
+	explicit_bzero(k, sizeof(k));
+}
+#endif /* RIJNDAEL_AESNI */
+
+#ifdef RIJNDAEL_ARMV8CE
+#ifdef __clang__
+#define	RIJNDAEL_TARGET	__attribute__((target("aes")))
+#else
+#define	RIJNDAEL_TARGET	__attribute__((target("+crypto")))
+#endif
+
+static int
+rijndael_hw_probe(void)
+{
+	return ((getauxval(AT_HWCAP) & HWCAP_AES) != 0);
+}
+
+/*
+ * AESE and AESD add the round key before substituting rather than after,
+ * so round r of the usual description uses key r - 1 here and the last
+ * key is added on its own.
+ */
+#define	AES_LOADKEYS(k, keys, Nr) do {					\
+	int r_;								\
+	for (r_ = 0; r_ <= (Nr); r_++)					\
+		(k)[r_] = vld1q_u8((keys)[r_]);				\
+} while (0)
+
+#define	AES_CTR_BLOCK(hi, lo)						\
+	vreinterpretq_u8_u64(vcombine_u64(				\
+	    vcreate_u64(__builtin_bswap64(hi)),				\
+	    vcreate_u64(__builtin_bswap64(lo))))
+
+#define	AES_XTS_BLOCK(hi, lo)						\
+	vreinterpretq_u8_u64(vcombine_u64(vcreate_u64(lo), vcreate_u64(hi)))
+
+RIJNDAEL_TARGET static void
+rijndael_hw_encrypt(const u32 *rk, int Nr, const u8 *in, u8 *out,
+    size_t nblocks)
+{
+	u8 keys[RIJNDAEL_MAXNR + 1][16];
+	uint8x16_t k[RIJNDAEL_MAXNR + 1], s[4];
+	int r;
+
+	rijndael_hw_keys(rk, Nr, keys);
+	AES_LOADKEYS(k, keys, Nr);
+	for (; nblocks >= 4; nblocks -= 4, in += 64, out += 64) {
+		s[0] = vld1q_u8(in);
+		s[1] = vld1q_u8(in + 16);
+		s[2] = vld1q_u8(in + 32);
+		s[3] = vld1q_u8(in + 48);
+		for (r = 0; r < Nr - 1; r++) {
+			s[0] = vaesmcq_u8(vaeseq_u8(s[0], k[r]));
+			s[1] = vaesmcq_u8(vaeseq_u8(s[1], k[r]));
+			s[2] = vaesmcq_u8(vaeseq_u8(s[2], k[r]));
+			s[3] = vaesmcq_u8(vaeseq_u8(s[3], k[r]));
+		}
+		vst1q_u8(out, veorq_u8(vaeseq_u8(s[0], k[Nr - 1]), k[Nr]));
+		vst1q_u8(out + 16, veorq_u8(vaeseq_u8(s[1], k[Nr - 1]), k[Nr]));
+		vst1q_u8(out + 32, veorq_u8(vaeseq_u8(s[2], k[Nr - 1]), k[Nr]));
+		vst1q_u8(out + 48, veorq_u8(vaeseq_u8(s[3], k[Nr - 1]), k[Nr]));
+	}
+	for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+		s[0] = vld1q_u8(in);
+		for (r = 0; r < Nr - 1; r++)
+			s[0] = vaesmcq_u8(vaeseq_u8(s[0], k[r]));
+		vst1q_u8(out, veorq_u8(vaeseq_u8(s[0], k[Nr - 1]), k[Nr]));
+	}
+	explicit_bzero(keys, sizeof(keys));
+	explicit_bzero(k, sizeof(k));
+}
+
+RIJNDAEL_TARGET static void
+rijndael_hw_decrypt(const u32 *rk, int Nr, const u8 *in, u8 *out,
+    size_t nblocks)
+{
+	u8 keys[RIJNDAEL_MAXNR + 1][16];
+	uint8x16_t k[RIJNDAEL_MAXNR + 1], s[4];
+	int r;
+
+	rijndael_hw_keys(rk, Nr, keys);
+	AES_LOADKEYS(k, keys, Nr);
+	for (; nblocks >= 4; nblocks -= 4, in += 64, out += 64) {
+		s[0] = vld1q_u8(in);
+		s[1] = vld1q_u8(in + 16);
+		s[2] = vld1q_u8(in + 32);
+		s[3] = vld1q_u8(in + 48);
+		for (r = 0; r < Nr - 1; r++) {
+			s[0] = vaesimcq_u8(vaesdq_u8(s[0], k[r]));
+			s[1] = vaesimcq_u8(vaesdq_u8(s[1], k[r]));
+			s[2] = vaesimcq_u8(vaesdq_u8(s[2], k[r]));
+			s[3] = vaesimcq_u8(vaesdq_u8(s[3], k[r]));
+		}
+		vst1q_u8(out, veorq_u8(vaesdq_u8(s[0], k[Nr - 1]), k[Nr]));
+		vst1q_u8(out + 16, veorq_u8(vaesdq_u8(s[1], k[Nr - 1]), k[Nr]));
+		vst1q_u8(out + 32, veorq_u8(vaesdq_u8(s[2], k[Nr - 1]), k[Nr]));
+		vst1q_u8(out + 48, veorq_u8(vaesdq_u8(s[3], k[Nr - 1]), k[Nr]));
+	}
+	for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+		s[0] = vld1q_u8(in);
+		for (r = 0; r < Nr - 1; r++)
+			s[0] = vaesimcq_u8(vaesdq_u8(s[0], k[r]));
+		vst1q_u8(out, veorq_u8(vaesdq_u8(s[0], k[Nr - 1]), k[Nr]));
+	}
+	explicit_bzero(keys, sizeof(keys));
+	explicit_bzero(k, sizeof(k));
+}
+
+RIJNDAEL_TARGET static void
+rijndael_hw_cbc_encrypt(const u32 *rk, int Nr, const u8 iv[16],
+    const u8 *in, u8 *out, size_t nblocks)
+{
+	u8 keys[RIJNDAEL_MAXNR + 1][16];
+	uint8x16_t k[RIJNDAEL_MAXNR + 1], s;
+	int r;
+
+	rijndael_hw_keys(rk, Nr, keys);
+	AES_LOADKEYS(k, keys, Nr);
+	s = vld1q_u8(iv);
+	for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+		s = veorq_u8(s, vld1q_u8(in));
+		for (r = 0; r < Nr - 1; r++)
+			s = vaesmcq_u8(vaeseq_u8(s, k[r]));
+		s = veorq_u8(vaeseq_u8(s, k[Nr - 1]), k[Nr]);
+		vst1q_u8(out, s);
+	}
+	explicit_bzero(keys, sizeof(keys));
+	explicit_bzero(k, sizeof(k));
+}
+
+RIJNDAEL_TARGET static void
+rijndael_hw_cbc_decrypt(const u32 *rk, int Nr, const u8 iv[16],
+    const u8 *in, u8 *out, size_t nblocks)
+{
+	u8 keys[RIJNDAEL_MAXNR + 1][16];
+	uint8x16_t k[RIJNDAEL_MAXNR + 1], c[4], prev, s[4];
+	int r;
+
+	rijndael_hw_keys(rk, Nr, keys);
+	AES_LOADKEYS(k, keys, Nr);
+	prev = vld1q_u8(iv);
+	/* Unlike encryption the blocks are independent until the XOR. */
+	for (; nblocks >= 4; nblocks -= 4, in += 64, out += 64) {
+		s[0] = c[0] = vld1q_u8(in);
+		s[1] = c[1] = vld1q_u8(in + 16);
+		s[2] = c[2] = vld1q_u8(in + 32);
+		s[3] = c[3] = vld1q_u8(in + 48);
+		for (r = 0; r < Nr - 1; r++) {
+			s[0] = vaesimcq_u8(vaesdq_u8(s[0], k[r]));
+			s[1] = vaesimcq_u8(vaesdq_u8(s[1], k[r]));
+			s[2] = vaesimcq_u8(vaesdq_u8(s[2], k[r]));
+			s[3] = vaesimcq_u8(vaesdq_u8(s[3], k[r]));
+		}
+		s[0] = veorq_u8(vaesdq_u8(s[0], k[Nr - 1]), k[Nr]);
+		s[1] = veorq_u8(vaesdq_u8(s[1], k[Nr - 1]), k[Nr]);
+		s[2] = veorq_u8(vaesdq_u8(s[2], k[Nr - 1]), k[Nr]);
+		s[3] = veorq_u8(vaesdq_u8(s[3], k[Nr - 1]), k[Nr]);
+		vst1q_u8(out, veorq_u8(s[0], prev));
+		vst1q_u8(out + 16, veorq_u8(s[1], c[0]));
+		vst1q_u8(out + 32, veorq_u8(s[2], c[1]));
+		vst1q_u8(out + 48, veorq_u8(s[3], c[2]));
+		prev = c[3];
+	}
+	for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+		s[0] = c[0] = vld1q_u8(in);
+		for (r = 0; r < Nr - 1; r++)
+			s[0] = vaesimcq_u8(vaesdq_u8(s[0], k[r]));
+		s[0] = veorq_u8(vaesdq_u8(s[0], k[Nr - 1]), k[Nr]);
+		vst1q_u8(out, veorq_u8(s[0], prev));
+		prev = c[0];
+	}
+	explicit_bzero(keys, sizeof(keys));
+	explicit_bzero(k, sizeof(k));
+}
+
+RIJNDAEL_TARGET static void
+rijndael_hw_ctr(const u32 *rk, int Nr, uint64_t ctr[2], const u8 *in,
+    u8 *out, size_t nblocks)
+{
+	u8 keys[RIJNDAEL_MAXNR + 1][16];
+	uint8x16_t k[RIJNDAEL_MAXNR + 1], s[4];
+	uint64_t hi, lo;
+	int r;
+
+	rijndael_hw_keys(rk, Nr, keys);
+	AES_LOADKEYS(k, keys, Nr);
+	hi = ctr[0];
+	lo = ctr[1];
+	for (; nblocks >= 4; nblocks -= 4, in += 64, out += 64) {
+		s[0] = AES_CTR_BLOCK(hi, lo);
+		AES_CTR_INC(hi, lo);
+		s[1] = AES_CTR_BLOCK(hi, lo);
+		AES_CTR_INC(hi, lo);
+		s[2] = AES_CTR_BLOCK(hi, lo);
+		AES_CTR_INC(hi, lo);
+		s[3] = AES_CTR_BLOCK(hi, lo);
+		AES_CTR_INC(hi, lo);
+		for (r = 0; r < Nr - 1; r++) {
+			s[0] = vaesmcq_u8(vaeseq_u8(s[0], k[r]));
+			s[1] = vaesmcq_u8(vaeseq_u8(s[1], k[r]));
+			s[2] = vaesmcq_u8(vaeseq_u8(s[2], k[r]));
+			s[3] = vaesmcq_u8(vaeseq_u8(s[3], k[r]));
+		}
+		s[0] = veorq_u8(vaeseq_u8(s[0], k[Nr - 1]), k[Nr]);
+		s[1] = veorq_u8(vaeseq_u8(s[1], k[Nr - 1]), k[Nr]);
+		s[2] = veorq_u8(vaeseq_u8(s[2], k[Nr - 1]), k[Nr]);
+		s[3] = veorq_u8(vaeseq_u8(s[3], k[Nr - 1]), k[Nr]);
+		vst1q_u8(out, veorq_u8(s[0], vld1q_u8(in)));
+		vst1q_u8(out + 16, veorq_u8(s[1], vld1q_u8(in + 16)));
+		vst1q_u8(out + 32, veorq_u8(s[2], vld1q_u8(in + 32)));
+		vst1q_u8(out + 48, veorq_u8(s[3], vld1q_u8(in + 48)));
+	}
+	for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+		s[0] = AES_CTR_BLOCK(hi, lo);
+		AES_CTR_INC(hi, lo);
+		for (r = 0; r < Nr - 1; r++)
+			s[0] = vaesmcq_u8(vaeseq_u8(s[0], k[r]));
+		s[0] = veorq_u8(vaeseq_u8(s[0], k[Nr - 1]), k[Nr]);
+		vst1q_u8(out, veorq_u8(s[0], vld1q_u8(in)));
+	}
+	ctr[0] = hi;
+	ctr[1] = lo;
+	explicit_bzero(keys, sizeof(keys));
+	explicit_bzero(k, sizeof(k));
+}
+
+RIJNDAEL_TARGET static void
+rijndael_hw_xts_encrypt(const u32 *rk, int Nr, const u8 tweak[16],
+    const u8 *in, u8 *out, size_t nblocks)
+{
+	u8 keys[RIJNDAEL_MAXNR + 1][16];
+	uint8x16_t k[RIJNDAEL_MAXNR + 1], s[4], t[4];
+	uint64_t hi, lo;
+	int r;
+
+	rijndael_hw_keys(rk, Nr, keys);
+	AES_LOADKEYS(k, keys, Nr);
+	memcpy(&lo, tweak, 8);
+	memcpy(&hi, tweak + 8, 8);
+	for (; nblocks >= 4; nblocks -= 4, in += 64, out += 64) {
+		t[0] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		t[1] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		t[2] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		t[3] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		s[0] = veorq_u8(vld1q_u8(in), t[0]);
+		s[1] = veorq_u8(vld1q_u8(in + 16), t[1]);
+		s[2] = veorq_u8(vld1q_u8(in + 32), t[2]);
+		s[3] = veorq_u8(vld1q_u8(in + 48), t[3]);
+		for (r = 0; r < Nr - 1; r++) {
+			s[0] = vaesmcq_u8(vaeseq_u8(s[0], k[r]));
+			s[1] = vaesmcq_u8(vaeseq_u8(s[1], k[r]));
+			s[2] = vaesmcq_u8(vaeseq_u8(s[2], k[r]));
+			s[3] = vaesmcq_u8(vaeseq_u8(s[3], k[r]));
+		}
+		s[0] = veorq_u8(vaeseq_u8(s[0], k[Nr - 1]), k[Nr]);
+		s[1] = veorq_u8(vaeseq_u8(s[1], k[Nr - 1]), k[Nr]);
+		s[2] = veorq_u8(vaeseq_u8(s[2], k[Nr - 1]), k[Nr]);
+		s[3] = veorq_u8(vaeseq_u8(s[3], k[Nr - 1]), k[Nr]);
+		vst1q_u8(out, veorq_u8(s[0], t[0]));
+		vst1q_u8(out + 16, veorq_u8(s[1], t[1]));
+		vst1q_u8(out + 32, veorq_u8(s[2], t[2]));
+		vst1q_u8(out + 48, veorq_u8(s[3], t[3]));
+	}
+	for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+		t[0] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		s[0] = veorq_u8(vld1q_u8(in), t[0]);
+		for (r = 0; r < Nr - 1; r++)
+			s[0] = vaesmcq_u8(vaeseq_u8(s[0], k[r]));
+		s[0] = veorq_u8(vaeseq_u8(s[0], k[Nr - 1]), k[Nr]);
+		vst1q_u8(out, veorq_u8(s[0], t[0]));
+	}
+	explicit_bzero(keys, sizeof(keys));
+	explicit_bzero(k, sizeof(k));
+}
+
+RIJNDAEL_TARGET static void
+rijndael_hw_xts_decrypt(const u32 *rk, int Nr, const u8 tweak[16],
+    const u8 *in, u8 *out, size_t nblocks)
+{
+	u8 keys[RIJNDAEL_MAXNR + 1][16];
+	uint8x16_t k[RIJNDAEL_MAXNR + 1], s[4], t[4];
+	uint64_t hi, lo;
+	int r;
+
+	rijndael_hw_keys(rk, Nr, keys);
+	AES_LOADKEYS(k, keys, Nr);
+	memcpy(&lo, tweak, 8);
+	memcpy(&hi, tweak + 8, 8);
+	for (; nblocks >= 4; nblocks -= 4, in += 64, out += 64) {
+		t[0] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		t[1] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		t[2] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		t[3] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		s[0] = veorq_u8(vld1q_u8(in), t[0]);
+		s[1] = veorq_u8(vld1q_u8(in + 16), t[1]);
+		s[2] = veorq_u8(vld1q_u8(in + 32), t[2]);
+		s[3] = veorq_u8(vld1q_u8(in + 48), t[3]);
+		for (r = 0; r < Nr - 1; r++) {
+			s[0] = vaesimcq_u8(vaesdq_u8(s[0], k[r]));
+			s[1] = vaesimcq_u8(vaesdq_u8(s[1], k[r]));
+			s[2] = vaesimcq_u8(vaesdq_u8(s[2], k[r]));
+			s[3] = vaesimcq_u8(vaesdq_u8(s[3], k[r]));
+		}
+		s[0] = veorq_u8(vaesdq_u8(s[0], k[Nr - 1]), k[Nr]);
+		s[1] = veorq_u8(vaesdq_u8(s[1], k[Nr - 1]), k[Nr]);
+		s[2] = veorq_u8(vaesdq_u8(s[2], k[Nr - 1]), k[Nr]);
+		s[3] = veorq_u8(vaesdq_u8(s[3], k[Nr - 1]), k[Nr]);
+		vst1q_u8(out, veorq_u8(s[0], t[0]));
+		vst1q_u8(out + 16, veorq_u8(s[1], t[1]));
+		vst1q_u8(out + 32, veorq_u8(s[2], t[2]));
+		vst1q_u8(out + 48, veorq_u8(s[3], t[3]));
+	}
+	for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+		t[0] = AES_XTS_BLOCK(hi, lo);
+		AES_XTS_MUL(hi, lo);
+		s[0] = veorq_u8(vld1q_u8(in), t[0]);
+		for (r = 0; r < Nr - 1; r++)
+			s[0] = vaesimcq_u8(vaesdq_u8(s[0], k[r]));
+		s[0] = veorq_u8(vaesdq_u8(s[0], k[Nr - 1]), k[Nr]);
+		vst1q_u8(out, veorq_u8(s[0], t[0]));
+	}
+	explicit_bzero(keys, sizeof(keys));
+	explicit_bzero(k, sizeof(k));
+}
+#endif /* RIJNDAEL_ARMV8CE */
+
+/* Whether the CPU has the AES instructions. */
+static inline int
+rijndael_hw_enabled(void)
+{
+
+	return (HW_PROBE_ONCE(rijndael_hw_probe) != 0);
+}
+#endif /* RIJNDAEL_AESNI || RIJNDAEL_ARMV8CE */
+
+#endif /* _RIJNDAEL_HW_H_ */
@@ -3,4 +3,28 @@
 /* the file should not be used from outside */
 typedef uint8_t			u8;
 typedef uint16_t		u16;
-typedef uint32_t		u32;
\ No newline at end of file
+typedef uint32_t		u32;
+
+/* table-free key schedules, identical to rijndaelKeySetupEnc()/Dec() */
+int	rijndaelKeySetupEncCT(u32 [/*4*(Nr+1)*/], const u8 [], int);
+int	rijndaelKeySetupDecCT(u32 [/*4*(Nr+1)*/], const u8 [], int);
+
+/*
+ * multi-block forms of rijndaelEncrypt()/rijndaelDecrypt(); bitsliced
+ * selects constant-time code over the T-tables where there are no AES
+ * instructions
+ */
+void	rijndaelEncryptECB(const u32 [/*4*(Nr+1)*/], int, int, const u8 *,
+	    u8 *, size_t);
+void	rijndaelDecryptECB(const u32 [/*4*(Nr+1)*/], int, int, const u8 *,
+	    u8 *, size_t);
+void	rijndaelEncryptCBC(const u32 [/*4*(Nr+1)*/], int, int, const u8 [16],
+	    const u8 *, u8 *, size_t);
+void	rijndaelDecryptCBC(const u32 [/*4*(Nr+1)*/], int, int, const u8 [16],
+	    const u8 *, u8 *, size_t);
+void	rijndaelEncryptCTR(const u32 [/*4*(Nr+1)*/], int, int, u8 [16],
+	    const u8 *, u8 *, size_t);
+void	rijndaelEncryptXTS(const u32 [/*4*(Nr+1)*/], int, int, const u8 [16],
+	    const u8 *, u8 *, size_t);
+void	rijndaelDecryptXTS(const u32 [/*4*(Nr+1)*/], int, int, const u8 [16],
+	    const u8 *, u8 *, size_t);
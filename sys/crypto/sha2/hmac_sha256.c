@@ -0,0 +1,185 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+#include <sys/types.h>
+#ifdef _KERNEL
+#include <sys/systm.h>
+#else
+#include <string.h>
+#endif
+
+#include <crypto/sha2/sha256.h>
+#include <crypto/sha2/hmac_sha256.h>
+
+/*
+ * Precompute the inner and outer states for key.  Keys longer than a
+ * block are hashed first, as RFC 2104 requires.
+ */
+void
+HMAC_SHA256_SetKey(HMAC_SHA256_KEY *k, const void *key, size_t keylen)
+{
+	unsigned char pad[SHA256_BLOCK_LENGTH];
+	unsigned char khash[SHA256_DIGEST_LENGTH];
+	size_t i;
+
+	if (keylen > SHA256_BLOCK_LENGTH) {
+		SHA256_Init(&k->ictx);
+		SHA256_Update(&k->ictx, key, keylen);
+		SHA256_Final(khash, &k->ictx);
+		key = khash;
+		keylen = SHA256_DIGEST_LENGTH;
+	}
+
+	memset(pad, 0x36, sizeof(pad));
+	for (i = 0; i < keylen; i++)
+		pad[i] ^= ((const unsigned char *)key)[i];
+	SHA256_Init(&k->ictx);
+	SHA256_Update(&k->ictx, pad, sizeof(pad));
+
+	for (i = 0; i < sizeof(pad); i++)
+		pad[i] ^= 0x36 ^ 0x5c;
+	SHA256_Init(&k->octx);
+	SHA256_Update(&k->octx, pad, sizeof(pad));
+
+	explicit_bzero(pad, sizeof(pad));
+	explicit_bzero(khash, sizeof(khash));
+}
+
+/* Start a MAC from the precomputed states. */
+void
+HMAC_SHA256_Init(HMAC_SHA256_CTX *ctx, const HMAC_SHA256_KEY *k)
+{
+
+	ctx->ictx = k->ictx;
+	ctx->octx = k->octx;
+}
+
+void
+HMAC_SHA256_Update(HMAC_SHA256_CTX *ctx, const void *in, size_t len)
+{
+
+	SHA256_Update(&ctx->ictx, in, len);
+}
+
+/* Finish the MAC into digest and clear the context. */
+void
+HMAC_SHA256_Final(unsigned char digest[static SHA256_DIGEST_LENGTH],
+    HMAC_SHA256_CTX *ctx)
+{
+	unsigned char ihash[SHA256_DIGEST_LENGTH];
+
+	SHA256_Final(ihash, &ctx->ictx);
+	SHA256_Update(&ctx->octx, ihash, sizeof(ihash));
+	SHA256_Final(digest, &ctx->octx);
+	explicit_bzero(ihash, sizeof(ihash));
+}
+
+/* MAC a whole message. */
+void
+HMAC_SHA256(const HMAC_SHA256_KEY *k, const void *in, size_t len,
+    unsigned char digest[static SHA256_DIGEST_LENGTH])
+{
+	HMAC_SHA256_CTX ctx;
+
+	HMAC_SHA256_Init(&ctx, k);
+	HMAC_SHA256_Update(&ctx, in, len);
+	HMAC_SHA256_Final(digest, &ctx);
+}
+
+/*
+ * HKDF-Extract: prk = HMAC(salt, ikm).  A missing salt is a block of
+ * zeroes, which as an HMAC key is the same as an empty one.
+ */
+void
+HKDF_SHA256_Extract(unsigned char prk[static SHA256_DIGEST_LENGTH],
+    const void *salt, size_t saltlen, const void *ikm, size_t ikmlen)
+{
+	HMAC_SHA256_KEY k;
+
+	HMAC_SHA256_SetKey(&k, salt, salt != NULL ? saltlen : 0);
+	HMAC_SHA256(&k, ikm, ikmlen, prk);
+	explicit_bzero(&k, sizeof(k));
+}
+
+/*
+ * HKDF-Expand: fill okm with T(1) | T(2) | ..., where T(i) is
+ * HMAC(prk, T(i - 1) | info | i).  The key is set up once for all of the
+ * blocks.  Returns -1 if more than HKDF_SHA256_MAX_OKM bytes are asked
+ * for, 0 otherwise.
+ */
+int
+HKDF_SHA256_Expand(void *okm, size_t okmlen, const void *prk, size_t prklen,
+    const void *info, size_t infolen)
+{
+	HMAC_SHA256_KEY k;
+	HMAC_SHA256_CTX ctx;
+	unsigned char t[SHA256_DIGEST_LENGTH];
+	unsigned char *out = okm;
+	unsigned char i;
+	size_t n;
+
+	if (okmlen > HKDF_SHA256_MAX_OKM)
+		return (-1);
+
+	HMAC_SHA256_SetKey(&k, prk, prklen);
+	for (i = 1; okmlen > 0; i++) {
+		HMAC_SHA256_Init(&ctx, &k);
+		if (i > 1)
+			HMAC_SHA256_Update(&ctx, t, sizeof(t));
+		HMAC_SHA256_Update(&ctx, info, infolen);
+		HMAC_SHA256_Update(&ctx, &i, 1);
+		HMAC_SHA256_Final(t, &ctx);
+		n = okmlen < sizeof(t) ? okmlen : sizeof(t);
+		memcpy(out, t, n);
+		out += n;
+		okmlen -= n;
+	}
+	explicit_bzero(&k, sizeof(k));
+	explicit_bzero(t, sizeof(t));
+	return (0);
+}
+
+/* HKDF-Extract and then HKDF-Expand. */
+int
+HKDF_SHA256(void *okm, size_t okmlen, const void *ikm, size_t ikmlen,
+    const void *salt, size_t saltlen, const void *info, size_t infolen)
+{
+	unsigned char prk[SHA256_DIGEST_LENGTH];
+	int error;
+
+	if (okmlen > HKDF_SHA256_MAX_OKM)
+		return (-1);
+	HKDF_SHA256_Extract(prk, salt, saltlen, ikm, ikmlen);
+	error = HKDF_SHA256_Expand(okm, okmlen, prk, sizeof(prk), info,
+	    infolen);
+	explicit_bzero(prk, sizeof(prk));
+	return (error);
+}
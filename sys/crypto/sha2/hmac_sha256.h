@@ -0,0 +1,76 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _HMAC_SHA256_H_
+#define	_HMAC_SHA256_H_
+
+#include <crypto/sha2/sha256.h>
+
+/*
+ * HMAC-SHA256 (RFC 2104) and HKDF-SHA256 (RFC 5869).
+ *
+ * HMAC_SHA256_SetKey() absorbs the key XOR ipad and the key XOR opad
+ * blocks into two SHA-256 states once.  Each MAC then starts from copies
+ * of those, so it costs the message blocks and two finalizations rather
+ * than two extra compressions for the pads.  A key may be shared by any
+ * number of contexts, and by threads, since nothing writes to it after
+ * setup.
+ */
+
+typedef struct HMAC_SHA256Key {
+	SHA256_CTX	ictx;		/* state after key ^ ipad */
+	SHA256_CTX	octx;		/* state after key ^ opad */
+} HMAC_SHA256_KEY;
+
+typedef struct HMAC_SHA256Context {
+	SHA256_CTX	ictx;		/* inner hash of the message */
+	SHA256_CTX	octx;		/* outer hash, waiting for the inner */
+} HMAC_SHA256_CTX;
+
+#define	HKDF_SHA256_MAX_OKM	(255 * SHA256_DIGEST_LENGTH)
+
+__BEGIN_DECLS
+void	HMAC_SHA256_SetKey(HMAC_SHA256_KEY *, const void *, size_t);
+void	HMAC_SHA256_Init(HMAC_SHA256_CTX *, const HMAC_SHA256_KEY *);
+void	HMAC_SHA256_Update(HMAC_SHA256_CTX *, const void *, size_t);
+void	HMAC_SHA256_Final(unsigned char [__min_size(SHA256_DIGEST_LENGTH)],
+    HMAC_SHA256_CTX *);
+void	HMAC_SHA256(const HMAC_SHA256_KEY *, const void *, size_t,
+    unsigned char [__min_size(SHA256_DIGEST_LENGTH)]);
+
+void	HKDF_SHA256_Extract(unsigned char [__min_size(SHA256_DIGEST_LENGTH)],
+    const void *, size_t, const void *, size_t);
+int	HKDF_SHA256_Expand(void *, size_t, const void *, size_t, const void *,
+    size_t);
+int	HKDF_SHA256(void *, size_t, const void *, size_t, const void *, size_t,
+    const void *, size_t);
+__END_DECLS
+
+#endif /* !_HMAC_SHA256_H_ */
@@ -76,6 +76,9 @@ __BEGIN_DECLS
 #ifndef SHA256_Transform
 #define SHA256_Transform	_libmd_SHA256_Transform
 #endif
+#ifndef SHA256_Multi
+#define SHA256_Multi		_libmd_SHA256_Multi
+#endif
 #ifndef SHA256_version
 #define SHA256_version		_libmd_SHA256_version
 #endif
@@ -84,6 +87,8 @@ void	SHA256_Init(SHA256_CTX *);
 void	SHA256_Update(SHA256_CTX *, const void *, size_t);
 void	SHA256_Final(unsigned char [__min_size(SHA256_DIGEST_LENGTH)],
     SHA256_CTX *);
+void	SHA256_Multi(unsigned char (*)[SHA256_DIGEST_LENGTH],
+    const void * const *, const size_t *, size_t);
 #ifndef _KERNEL
 char   *SHA256_End(SHA256_CTX *, char *);
 char   *SHA256_Data(const void *, unsigned int, char *);
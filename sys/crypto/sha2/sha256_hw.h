@@ -0,0 +1,228 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * SHA-256 compression with the SHA extensions on x86 (SHA-NI) and the
+ * ARMv8 SHA2 instructions on AArch64, picked at run time when the CPU has
+ * them.  sha256c.c falls back to SHA256_Transform() otherwise.
+ *
+ * Only userland uses this; the kernel must not touch vector registers
+ * here, so _KERNEL builds keep to the scalar code.
+ */
+
+#ifndef _SHA256_HW_H_
+#define	_SHA256_HW_H_
+
+#if !defined(_KERNEL) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define	SHA256_SHANI	1
+#elif !defined(_KERNEL) && defined(__aarch64__) && defined(__linux__) && \
+    defined(__AARCH64EL__) && (defined(__ARM_FEATURE_SHA2) || \
+    defined(__ARM_FEATURE_CRYPTO) || !defined(__clang__) || \
+    __clang_major__ >= 16)
+/* Older clang only declares the SHA2 intrinsics when built for them. */
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_SHA2
+#define	HWCAP_SHA2	(1 << 6)
+#endif
+#define	SHA256_ARMV8CE	1
+#endif
+
+#if defined(SHA256_SHANI) || defined(SHA256_ARMV8CE)
+#define	SHA256_HW	1
+
+#include <sys/hw_probe.h>
+
+#ifdef SHA256_SHANI
+#define	SHA256_TARGET	__attribute__((target("sha,sse4.1,ssse3")))
+
+static int
+sha256_hw_probe(void)
+{
+	unsigned int eax, ebx, ecx, edx;
+
+	if (__get_cpuid_max(0, NULL) < 7 ||
+	    !__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		return (0);
+	if ((ecx & bit_SSSE3) == 0 || (ecx & bit_SSE4_1) == 0)
+		return (0);
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+	return ((ebx & bit_SHA) != 0);
+}
+
+/*
+ * SHA256RNDS2 keeps the working variables as ABEF and CDGH and does two
+ * rounds per instruction, taking W + K for them from the low half of its
+ * third operand.  Each message vector holds four schedule words; w0 is
+ * replaced by the next four, derived from it and the following three.
+ */
+#define	SHA256_ROUNDS4(abef, cdgh, w, k, i) do {			\
+	__m128i wk_ = _mm_add_epi32((w),				\
+	    _mm_loadu_si128((const __m128i *)(k) + (i)));		\
+	(cdgh) = _mm_sha256rnds2_epu32((cdgh), (abef), wk_);		\
+	(abef) = _mm_sha256rnds2_epu32((abef), (cdgh),			\
+	    _mm_shuffle_epi32(wk_, 0x0e));				\
+} while (0)
+
+#define	SHA256_SCHED4(w0, w1, w2, w3)					\
+	(w0) = _mm_sha256msg2_epu32(_mm_add_epi32(			\
+	    _mm_sha256msg1_epu32((w0), (w1)),				\
+	    _mm_alignr_epi8((w3), (w2), 4)), (w3))
+
+SHA256_TARGET static void
+sha256_hw_blocks(uint32_t state[8], const unsigned char *in, size_t nblocks,
+    const uint32_t k[64])
+{
+	const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+	    0x0405060700010203ULL);
+	__m128i abef, cdgh, abef0, cdgh0, w0, w1, w2, w3, t;
+	int i;
+
+	t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)state), 0xb1);
+	cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)state + 1),
+	    0x1b);
+	abef = _mm_alignr_epi8(t, cdgh, 8);
+	cdgh = _mm_blend_epi16(cdgh, t, 0xf0);
+
+	for (; nblocks > 0; nblocks--, in += 64) {
+		abef0 = abef;
+		cdgh0 = cdgh;
+		w0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)in),
+		    bswap);
+		w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)in + 1),
+		    bswap);
+		w2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)in + 2),
+		    bswap);
+		w3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)in + 3),
+		    bswap);
+		SHA256_ROUNDS4(abef, cdgh, w0, k, 0);
+		SHA256_ROUNDS4(abef, cdgh, w1, k, 1);
+		SHA256_ROUNDS4(abef, cdgh, w2, k, 2);
+		SHA256_ROUNDS4(abef, cdgh, w3, k, 3);
+		for (i = 4; i < 16; i += 4) {
+			SHA256_SCHED4(w0, w1, w2, w3);
+			SHA256_ROUNDS4(abef, cdgh, w0, k, i);
+			SHA256_SCHED4(w1, w2, w3, w0);
+			SHA256_ROUNDS4(abef, cdgh, w1, k, i + 1);
+			SHA256_SCHED4(w2, w3, w0, w1);
+			SHA256_ROUNDS4(abef, cdgh, w2, k, i + 2);
+			SHA256_SCHED4(w3, w0, w1, w2);
+			SHA256_ROUNDS4(abef, cdgh, w3, k, i + 3);
+		}
+		abef = _mm_add_epi32(abef, abef0);
+		cdgh = _mm_add_epi32(cdgh, cdgh0);
+	}
+
+	t = _mm_shuffle_epi32(abef, 0x1b);
+	cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+	_mm_storeu_si128((__m128i *)state, _mm_blend_epi16(t, cdgh, 0xf0));
+	_mm_storeu_si128((__m128i *)state + 1, _mm_alignr_epi8(cdgh, t, 8));
+}
+#endif /* SHA256_SHANI */
+
+#ifdef SHA256_ARMV8CE
+#ifdef __clang__
+#define	SHA256_TARGET	__attribute__((target("sha2")))
+#else
+#define	SHA256_TARGET	__attribute__((target("+crypto")))
+#endif
+
+static int
+sha256_hw_probe(void)
+{
+	return ((getauxval(AT_HWCAP) & HWCAP_SHA2) != 0);
+}
+
+/*
+ * SHA256H and SHA256H2 do four rounds between them on ABCD and EFGH; the
+ * schedule comes four words at a time from SHA256SU0 and SHA256SU1.
+ */
+#define	SHA256_ROUNDS4(abcd, efgh, w, k, i) do {			\
+	uint32x4_t wk_ = vaddq_u32((w), vld1q_u32((k) + 4 * (i)));	\
+	uint32x4_t t_ = (abcd);						\
+	(abcd) = vsha256hq_u32((abcd), (efgh), wk_);			\
+	(efgh) = vsha256h2q_u32((efgh), t_, wk_);			\
+} while (0)
+
+#define	SHA256_SCHED4(w0, w1, w2, w3)					\
+	(w0) = vsha256su1q_u32(vsha256su0q_u32((w0), (w1)), (w2), (w3))
+
+SHA256_TARGET static void
+sha256_hw_blocks(uint32_t state[8], const unsigned char *in, size_t nblocks,
+    const uint32_t k[64])
+{
+	uint32x4_t abcd, efgh, abcd0, efgh0, w0, w1, w2, w3;
+	int i;
+
+	abcd = vld1q_u32(state);
+	efgh = vld1q_u32(state + 4);
+
+	for (; nblocks > 0; nblocks--, in += 64) {
+		abcd0 = abcd;
+		efgh0 = efgh;
+		w0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(in)));
+		w1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(in + 16)));
+		w2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(in + 32)));
+		w3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(in + 48)));
+		SHA256_ROUNDS4(abcd, efgh, w0, k, 0);
+		SHA256_ROUNDS4(abcd, efgh, w1, k, 1);
+		SHA256_ROUNDS4(abcd, efgh, w2, k, 2);
+		SHA256_ROUNDS4(abcd, efgh, w3, k, 3);
+		for (i = 4; i < 16; i += 4) {
+			SHA256_SCHED4(w0, w1, w2, w3);
+			SHA256_ROUNDS4(abcd, efgh, w0, k, i);
+			SHA256_SCHED4(w1, w2, w3, w0);
+			SHA256_ROUNDS4(abcd, efgh, w1, k, i + 1);
+			SHA256_SCHED4(w2, w3, w0, w1);
+			SHA256_ROUNDS4(abcd, efgh, w2, k, i + 2);
+			SHA256_SCHED4(w3, w0, w1, w2);
+			SHA256_ROUNDS4(abcd, efgh, w3, k, i + 3);
+		}
+		abcd = vaddq_u32(abcd, abcd0);
+		efgh = vaddq_u32(efgh, efgh0);
+	}
+
+	vst1q_u32(state, abcd);
+	vst1q_u32(state + 4, efgh);
+}
+#endif /* SHA256_ARMV8CE */
+
+/* Whether the CPU has the SHA-256 instructions. */
+static inline int
+sha256_hw_enabled(void)
+{
+
+	return (HW_PROBE_ONCE(sha256_hw_probe) != 0);
+}
+#endif /* SHA256_SHANI || SHA256_ARMV8CE */
+
+#endif /* !_SHA256_HW_H_ */
@@ -0,0 +1,176 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Multi-buffer SHA-256 compression for SHA256_Multi() in sha256c.c.
+ *
+ * One call compresses nblocks consecutive blocks from each of W
+ * independent messages.  Word i of the W states lives in lane 0..W-1 of
+ * one vector, and so does each message schedule word, so every round
+ * works on W messages at once.  The code is written once with the
+ * compiler's generic vector types, which become SSE2, AVX2 or AVX-512 on
+ * x86 and NEON on ARM; the AVX2 and AVX-512 variants are picked at run
+ * time when the CPU and OS support them.  The kernel must not touch
+ * vector registers here, so _KERNEL builds hash the messages one at a
+ * time.
+ */
+
+#ifndef _SHA256_MB_H_
+#define	_SHA256_MB_H_
+
+#if !defined(_KERNEL) && (defined(__x86_64__) || defined(__i386__)) && \
+    defined(__SSE2__)
+#include <sys/hw_probe.h>
+#define	SHA256_MB	1
+#define	SHA256_MB_AVX2	1
+#elif !defined(_KERNEL) && defined(__ARM_NEON)
+#define	SHA256_MB	1
+#endif
+
+#ifdef SHA256_MB
+#define	SHA256_MB_MAXLANES	16
+
+typedef uint32_t sha256_v4 __attribute__((vector_size(16)));
+#ifdef SHA256_MB_AVX2
+typedef uint32_t sha256_v8 __attribute__((vector_size(32)));
+typedef uint32_t sha256_v16 __attribute__((vector_size(64)));
+#endif
+
+#define	SHA256_VROTR(v, n)	(((v) >> (n)) | ((v) << (32 - (n))))
+#define	SHA256_VS0(x)							\
+	(SHA256_VROTR(x, 2) ^ SHA256_VROTR(x, 13) ^ SHA256_VROTR(x, 22))
+#define	SHA256_VS1(x)							\
+	(SHA256_VROTR(x, 6) ^ SHA256_VROTR(x, 11) ^ SHA256_VROTR(x, 25))
+#define	SHA256_Vs0(x)							\
+	(SHA256_VROTR(x, 7) ^ SHA256_VROTR(x, 18) ^ ((x) >> 3))
+#define	SHA256_Vs1(x)							\
+	(SHA256_VROTR(x, 17) ^ SHA256_VROTR(x, 19) ^ ((x) >> 10))
+
+/* Round i, with the schedule word for it computed first if i >= 16. */
+#define	SHA256_VRND(a, b, c, d, e, f, g, h, i) do {			\
+	if ((i) >= 16)							\
+		w[(i) & 15] += SHA256_Vs1(w[((i) - 2) & 15]) +		\
+		    w[((i) - 7) & 15] + SHA256_Vs0(w[((i) - 15) & 15]);	\
+	h += SHA256_VS1(e) + ((e & (f ^ g)) ^ g) + k[i] + w[(i) & 15];	\
+	d += h;								\
+	h += SHA256_VS0(a) + ((a & (b | c)) | (b & c));			\
+} while (0)
+
+#define	SHA256_VRND8(i) do {						\
+	SHA256_VRND(a, b, c, d, e, f, g, h, (i));			\
+	SHA256_VRND(h, a, b, c, d, e, f, g, (i) + 1);			\
+	SHA256_VRND(g, h, a, b, c, d, e, f, (i) + 2);			\
+	SHA256_VRND(f, g, h, a, b, c, d, e, (i) + 3);			\
+	SHA256_VRND(e, f, g, h, a, b, c, d, (i) + 4);			\
+	SHA256_VRND(d, e, f, g, h, a, b, c, (i) + 5);			\
+	SHA256_VRND(c, d, e, f, g, h, a, b, (i) + 6);			\
+	SHA256_VRND(b, c, d, e, f, g, h, a, (i) + 7);			\
+} while (0)
+
+/*
+ * Define a function that compresses nblocks blocks into each of W states.
+ * st[W * i + l] is word i of lane l's state, and lane l reads its blocks
+ * from p[l] on.
+ */
+#define	SHA256_MB_BLOCKS(name, vtype, W, attr)				\
+static attr void							\
+name(uint32_t *st, const unsigned char * const *p, size_t nblocks,	\
+    const uint32_t k[64])						\
+{									\
+	vtype s[8], w[16], a, b, c, d, e, f, g, h;			\
+	uint32_t t[16][W];						\
+	size_t n;							\
+	int i, l;							\
+									\
+	memcpy(s, st, sizeof(s));					\
+	for (n = 0; n < nblocks; n++) {					\
+		for (l = 0; l < W; l++)					\
+			for (i = 0; i < 16; i++)			\
+				t[i][l] = be32dec(p[l] + 64 * n + 4 * i);\
+		memcpy(w, t, sizeof(w));				\
+		a = s[0];						\
+		b = s[1];						\
+		c = s[2];						\
+		d = s[3];						\
+		e = s[4];						\
+		f = s[5];						\
+		g = s[6];						\
+		h = s[7];						\
+		for (i = 0; i < 64; i += 8)				\
+			SHA256_VRND8(i);				\
+		s[0] += a;						\
+		s[1] += b;						\
+		s[2] += c;						\
+		s[3] += d;						\
+		s[4] += e;						\
+		s[5] += f;						\
+		s[6] += g;						\
+		s[7] += h;						\
+	}								\
+	memcpy(st, s, sizeof(s));					\
+}
+
+SHA256_MB_BLOCKS(sha256_mb_blocks4, sha256_v4, 4, )
+#ifdef SHA256_MB_AVX2
+SHA256_MB_BLOCKS(sha256_mb_blocks8, sha256_v8, 8,
+    __attribute__((target("avx2"))))
+SHA256_MB_BLOCKS(sha256_mb_blocks16, sha256_v16, 16,
+    __attribute__((target("avx512f"))))
+
+/* 16 if the CPU and OS support AVX-512, 8 for AVX2, else 4. */
+static int
+sha256_mb_probe(void)
+{
+
+	switch (hw_x86_avx_level()) {
+	case HW_X86_AVX512F:
+		return (16);
+	case HW_X86_AVX2:
+		return (8);
+	default:
+		return (4);
+	}
+}
+#endif
+
+/* Number of lanes of the widest variant the CPU has, probed once. */
+static inline int
+sha256_mb_lanes(void)
+{
+
+#ifdef SHA256_MB_AVX2
+	return (HW_PROBE_ONCE(sha256_mb_probe));
+#else
+	return (4);
+#endif
+}
+#endif /* SHA256_MB */
+
+#endif /* !_SHA256_MB_H_ */
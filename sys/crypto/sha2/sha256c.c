@@ -35,6 +35,8 @@
 #endif
 
 #include "sha256.h"
+#include "sha256_hw.h"
+#include "sha256_mb.h"
 
 #if BYTE_ORDER == BIG_ENDIAN
 
@@ -185,6 +187,27 @@ SHA256_Transform(uint32_t * state, const unsigned char block[64])
 		state[i] += S[i];
 }
 
+/* Compress nblocks consecutive 64-byte blocks into the state. */
+static void
+SHA256_Blocks(uint32_t * state, const unsigned char *in, size_t nblocks)
+{
+
+#ifdef SHA256_HW
+	if (sha256_hw_enabled()) {
+		sha256_hw_blocks(state, in, nblocks, K);
+		return;
+	}
+#endif
+	for (; nblocks > 0; nblocks--, in += 64)
+		SHA256_Transform(state, in);
+}
+
+/* SHA256 initial hash value. */
+static const uint32_t SHA256_IV[8] = {
+	0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+	0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
 static unsigned char PAD[64] = {
 	0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -208,7 +231,7 @@ SHA256_Pad(SHA256_CTX * ctx)
 	} else {
 		/* Finish the current block and mix. */
 		memcpy(&ctx->buf[r], PAD, 64 - r);
-		SHA256_Transform(ctx->state, ctx->buf);
+		SHA256_Blocks(ctx->state, ctx->buf, 1);
 
 		/* The start of the final block is all zeroes. */
 		memset(&ctx->buf[0], 0, 56);
@@ -218,7 +241,7 @@ SHA256_Pad(SHA256_CTX * ctx)
 	be64enc(&ctx->buf[56], ctx->count);
 
 	/* Mix in the final block. */
-	SHA256_Transform(ctx->state, ctx->buf);
+	SHA256_Blocks(ctx->state, ctx->buf, 1);
 }
 
 /* SHA-256 initialization.  Begins a SHA-256 operation. */
@@ -230,14 +253,7 @@ SHA256_Init(SHA256_CTX * ctx)
 	ctx->count = 0;
 
 	/* Magic initialization constants */
-	ctx->state[0] = 0x6A09E667;
-	ctx->state[1] = 0xBB67AE85;
-	ctx->state[2] = 0x3C6EF372;
-	ctx->state[3] = 0xA54FF53A;
-	ctx->state[4] = 0x510E527F;
-	ctx->state[5] = 0x9B05688C;
-	ctx->state[6] = 0x1F83D9AB;
-	ctx->state[7] = 0x5BE0CD19;
+	memcpy(ctx->state, SHA256_IV, sizeof(SHA256_IV));
 }
 
 /* Add bytes into the hash */
@@ -265,15 +281,15 @@ SHA256_Update(SHA256_CTX * ctx, const void *in, size_t len)
 
 	/* Finish the current block */
 	memcpy(&ctx->buf[r], src, 64 - r);
-	SHA256_Transform(ctx->state, ctx->buf);
+	SHA256_Blocks(ctx->state, ctx->buf, 1);
 	src += 64 - r;
 	len -= 64 - r;
 
 	/* Perform complete blocks */
-	while (len >= 64) {
-		SHA256_Transform(ctx->state, src);
-		src += 64;
-		len -= 64;
+	if (len >= 64) {
+		SHA256_Blocks(ctx->state, src, len / 64);
+		src += len & ~(size_t)0x3f;
+		len &= 0x3f;
 	}
 
 	/* Copy left over data into buffer */
@@ -298,6 +314,126 @@ SHA256_Final(unsigned char digest[static SHA256_DIGEST_LENGTH], SHA256_CTX *ctx)
 	memset(ctx, 0, sizeof(*ctx));
 }
 
+#ifdef SHA256_MB
+/*
+ * Hash the messages W at a time in the lanes of sha256_mb_blocks*().  A
+ * lane runs through its message's whole blocks in place, then through
+ * the padded tail, which is one or two blocks built in pad[]; when it is
+ * done its digest is written and the next message starts in that lane.
+ * Each call compresses as many blocks as the lane nearest the end of a
+ * stage has left.  Idle lanes reread an active lane's input and their
+ * result is ignored.
+ */
+static void
+SHA256_Multi_lanes(unsigned char (*digests)[SHA256_DIGEST_LENGTH],
+    const void * const *msgs, const size_t *lens, size_t n, int W)
+{
+	uint32_t st[8 * SHA256_MB_MAXLANES];
+	const unsigned char *p[SHA256_MB_MAXLANES];
+	unsigned char pad[SHA256_MB_MAXLANES][128];
+	size_t left[SHA256_MB_MAXLANES], which[SHA256_MB_MAXLANES];
+	int stage[SHA256_MB_MAXLANES];	/* 0 idle, 1 blocks, 2 tail */
+	size_t next, nblocks, len, r;
+	int active, i, l;
+
+	for (l = 0; l < W; l++)
+		stage[l] = 0;
+	for (next = 0;;) {
+		active = -1;
+		nblocks = 0;
+		for (l = 0; l < W; l++) {
+			if (stage[l] != 0 && left[l] == 0 && stage[l]++ == 2) {
+				for (i = 0; i < 8; i++)
+					be32enc(digests[which[l]] + 4 * i,
+					    st[W * i + l]);
+				stage[l] = 0;
+			}
+			if (stage[l] == 0 && next < n) {
+				which[l] = next++;
+				for (i = 0; i < 8; i++)
+					st[W * i + l] = SHA256_IV[i];
+				p[l] = msgs[which[l]];
+				left[l] = lens[which[l]] / 64;
+				stage[l] = left[l] != 0 ? 1 : 2;
+			}
+			if (stage[l] == 2 && left[l] == 0) {
+				len = lens[which[l]];
+				r = len & 0x3f;
+				memcpy(pad[l], p[l], r);
+				left[l] = r < 56 ? 1 : 2;
+				memset(&pad[l][r], 0, 64 * left[l] - r);
+				pad[l][r] = 0x80;
+				be64enc(&pad[l][64 * left[l] - 8],
+				    (uint64_t)len << 3);
+				p[l] = pad[l];
+			}
+			if (stage[l] != 0) {
+				if (active < 0 || left[l] < nblocks)
+					nblocks = left[l];
+				active = l;
+			}
+		}
+		if (active < 0)
+			break;
+		for (l = 0; l < W; l++)
+			if (stage[l] == 0)
+				p[l] = p[active];
+#ifdef SHA256_MB_AVX2
+		if (W == 16)
+			sha256_mb_blocks16(st, p, nblocks, K);
+		else if (W == 8)
+			sha256_mb_blocks8(st, p, nblocks, K);
+		else
+#endif
+			sha256_mb_blocks4(st, p, nblocks, K);
+		for (l = 0; l < W; l++) {
+			if (stage[l] != 0) {
+				p[l] += 64 * nblocks;
+				left[l] -= nblocks;
+			}
+		}
+	}
+}
+#endif
+
+/*
+ * Hash n independent messages, msgs[i] of lens[i] bytes, into digests[i].
+ * The digests are the ones SHA256_Init(), SHA256_Update() and
+ * SHA256_Final() would give, but with SIMD the messages are hashed
+ * several at a time, which is much faster for many short ones.
+ */
+void
+SHA256_Multi(unsigned char (*digests)[SHA256_DIGEST_LENGTH],
+    const void * const *msgs, const size_t *lens, size_t n)
+{
+	SHA256_CTX ctx;
+	size_t i;
+#ifdef SHA256_MB
+	int lanes;
+#endif
+
+#ifdef SHA256_MB
+	/*
+	 * One SHA-NI or ARMv8 stream keeps up with 4 or 8 SIMD lanes;
+	 * AVX-512 lanes are still faster.
+	 */
+	lanes = sha256_mb_lanes();
+#ifdef SHA256_HW
+	if (lanes < 16 && sha256_hw_enabled())
+		lanes = 0;
+#endif
+	if (n > 1 && lanes != 0) {
+		SHA256_Multi_lanes(digests, msgs, lens, n, lanes);
+		return;
+	}
+#endif
+	for (i = 0; i < n; i++) {
+		SHA256_Init(&ctx);
+		SHA256_Update(&ctx, msgs[i], lens[i]);
+		SHA256_Final(digests[i], &ctx);
+	}
+}
+
 #ifdef WEAK_REFS
 /* When building libmd, provide weak references. Note: this is not
    activated in the context of compiling these sources for internal
@@ -311,4 +447,6 @@ __weak_reference(_libmd_SHA256_Update, SHA256_Update);
 __weak_reference(_libmd_SHA256_Final, SHA256_Final);
 #undef SHA256_Transform
 __weak_reference(_libmd_SHA256_Transform, SHA256_Transform);
+#undef SHA256_Multi
+__weak_reference(_libmd_SHA256_Multi, SHA256_Multi);
 #endif
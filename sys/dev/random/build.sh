@@ -0,0 +1,19 @@
+#!/bin/sh
+#
+# Build the host-side test of the Fortuna generator:
+#	sh build.sh && ./unit_test
+#
+# The repo's headers come after the system ones so that its sys/ does
+# not shadow the host C library's.  sha256c.c also needs the endian
+# helpers from unit_test.h.
+
+cd "$(dirname "$0")" || exit 1
+CFLAGS="-O2 -g -Wall -pthread -include stdint.h -D__FBSDID(x)= -D__min_size(x)=static(x) -idirafter ../.."
+${CC:-cc} ${CFLAGS} -include unit_test.h -c -o sha256c.o ../../crypto/sha2/sha256c.c || exit 1
+${CC:-cc} ${CFLAGS} -o unit_test \
+	unit_test.c \
+	fortuna.c \
+	hash.c \
+	../../crypto/rijndael/rijndael-alg-fst.c \
+	../../crypto/rijndael/rijndael-api-fst.c \
+	sha256c.o
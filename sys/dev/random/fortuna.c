@@ -0,0 +1,417 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Fortuna, by Niels Ferguson and Bruce Schneier ("Cryptography
+ * Engineering", chapter 9), as a drop-in alternative to yarrow.c: build
+ * this file instead of that one and random_alg_context is Fortuna.
+ *
+ * Entropy events are spread over 32 pools.  Reseed number r uses pool i
+ * only when 2^i divides r, so an attacker who can see or control some of
+ * the input still cannot starve the higher pools.  Reseeds happen when
+ * pool 0 has collected enough and at most every 100 ms.
+ *
+ * Output does not come from the central generator directly.  Each reader
+ * is handed one of RANDOM_FORTUNA_NOUT output contexts, picked by CPU in
+ * the kernel and by thread elsewhere, each with its own lock, AES key
+ * and counter.  A context takes a fresh key from the central generator
+ * when it is first used and after every reseed, which is the only time
+ * it touches the central lock, and like the central generator it
+ * replaces its key after every request.  Readers on different contexts
+ * therefore run in parallel, where yarrow.c holds its one lock for the
+ * whole of every read.
+ */
+
+#include <sys/cdefs.h>
+__FBSDID("$FreeBSD$");
+
+#include <sys/param.h>
+#ifdef _KERNEL
+#include <sys/malloc.h>
+#include <sys/mutex.h>
+#include <sys/systm.h>
+
+#include <crypto/rijndael/rijndael-api-fst.h>
+#include <crypto/sha2/sha256.h>
+
+#include <dev/random/hash.h>
+#include <dev/random/randomdev.h>
+#include <dev/random/random_harvestq.h>
+#include <dev/random/uint128.h>
+#include <dev/random/fortuna.h>
+#else /* !_KERNEL */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __LITEOS__
+#include <sys/mutex.h>
+
+#include "los_init.h"
+#include "los_task.h"
+#include "los_tick.h"
+#endif
+
+#include "unit_test.h"
+
+#include <crypto/rijndael/rijndael-api-fst.h>
+#include <crypto/sha2/sha256.h>
+
+#include <dev/random/hash.h>
+#include <dev/random/randomdev.h>
+#include <dev/random/uint128.h>
+#include <dev/random/fortuna.h>
+#endif /* _KERNEL */
+
+#include <dev/random/harvester.h>
+
+#define	RANDOM_FORTUNA_NPOOLS	32	/* The number of accumulation pools */
+#define	RANDOM_FORTUNA_DEFPOOLSIZE 64	/* The default pool size/length for a (re)seed */
+#define	RANDOM_FORTUNA_MAXPOOLSIZE (UINT_MAX/2) /* Cap on a pool's counted length */
+#define	RANDOM_FORTUNA_MAX_READ	(1 << 20)	/* Max bytes in a single read before rekeying */
+#define	RANDOM_FORTUNA_RESEED_MS 100	/* Minimum time between reseeds */
+#define	RANDOM_FORTUNA_NOUT	16	/* Output contexts; a power of 2 */
+
+/* This algorithm (and code) presumes that RANDOM_KEYSIZE is twice as large as RANDOM_BLOCKSIZE */
+CTASSERT(RANDOM_BLOCKSIZE == sizeof(uint128_t));
+CTASSERT(RANDOM_KEYSIZE == 2*RANDOM_BLOCKSIZE);
+CTASSERT((RANDOM_FORTUNA_NOUT & (RANDOM_FORTUNA_NOUT - 1)) == 0);
+
+/*
+ * This is the beastie that needs protecting. It contains all of the
+ * state that we are excited about. Exactly one is instantiated.
+ */
+static struct fortuna_state {
+	struct fs_pool {		/* P_i */
+		u_int fsp_length;	/* Only the first one is used by Fortuna */
+		struct randomdev_hash fsp_hash;
+	} fs_pool[RANDOM_FORTUNA_NPOOLS];
+	u_int fs_reseedcount;		/* ReseedCnt */
+	uint128_t fs_counter;		/* C */
+	struct randomdev_key fs_key;	/* K */
+	u_int fs_minpoolsize;		/* Extras */
+	uint64_t fs_lastreseed;		/* Time of the last reseed, in ms */
+	bool fs_seeded;
+	/* Reseed lock */
+	mtx_t fs_mtx;
+} fortuna_state;
+
+/*
+ * An output context: a generator of its own, keyed from the central
+ * one.  fo_reseedcount is the fs_reseedcount it was keyed at; zero
+ * means it has no key yet.
+ */
+static struct fortuna_output {
+	mtx_t fo_mtx;
+	uint128_t fo_counter;
+	struct randomdev_key fo_key;
+	u_int fo_reseedcount;
+} __aligned(64) fortuna_output[RANDOM_FORTUNA_NOUT];
+
+static void random_fortuna_pre_read(void);
+static void random_fortuna_read(uint8_t *, u_int);
+static bool random_fortuna_seeded(void);
+static void random_fortuna_process_event(struct harvest_event *);
+static void random_fortuna_init_alg(void *);
+static void random_fortuna_deinit_alg(void *);
+
+static void random_fortuna_reseed_internal(void);
+
+struct random_algorithm random_alg_context = {
+	.ra_ident = "Fortuna",
+	.ra_init_alg = random_fortuna_init_alg,
+	.ra_deinit_alg = random_fortuna_deinit_alg,
+	.ra_pre_read = random_fortuna_pre_read,
+	.ra_read = random_fortuna_read,
+	.ra_seeded = random_fortuna_seeded,
+	.ra_event_processor = random_fortuna_process_event,
+	.ra_poolcount = RANDOM_FORTUNA_NPOOLS,
+};
+
+/* Milliseconds on a monotonic clock, for spacing out reseeds. */
+static uint64_t
+random_fortuna_now_ms(void)
+{
+#ifdef __LITEOS__
+	return (LOS_TickCountGet() * 1000 / LOSCFG_BASE_CORE_TICK_PER_SECOND);
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+#endif
+}
+
+/* ARGSUSED */
+static void
+random_fortuna_init_alg(void *unused __unused)
+{
+	int i;
+
+	RANDOM_RESEED_INIT_LOCK();
+	/* Start unseeded, therefore blocked. */
+	fortuna_state.fs_seeded = false;
+	fortuna_state.fs_minpoolsize = RANDOM_FORTUNA_DEFPOOLSIZE;
+	fortuna_state.fs_lastreseed = 0;
+	/* F&S - InitializePRNG() */
+	/* F&S - P_i = \epsilon */
+	for (i = 0; i < RANDOM_FORTUNA_NPOOLS; i++) {
+		randomdev_hash_init(&fortuna_state.fs_pool[i].fsp_hash);
+		fortuna_state.fs_pool[i].fsp_length = 0;
+	}
+	/* F&S - ReseedCNT = 0 */
+	fortuna_state.fs_reseedcount = 0;
+	/* F&S - InitializeGenerator() */
+	/* F&S - C = 0 */
+	fortuna_state.fs_counter = UINT128_ZERO;
+	/* F&S - K = 0 */
+	explicit_bzero(&fortuna_state.fs_key, sizeof(fortuna_state.fs_key));
+	for (i = 0; i < RANDOM_FORTUNA_NOUT; i++) {
+		mtx_init(&fortuna_output[i].fo_mtx, "fortuna output", NULL, MTX_DEF);
+		fortuna_output[i].fo_reseedcount = 0;
+	}
+}
+
+/* ARGSUSED */
+static void
+random_fortuna_deinit_alg(void *unused __unused)
+{
+	int i;
+
+	for (i = 0; i < RANDOM_FORTUNA_NOUT; i++)
+		mtx_destroy(&fortuna_output[i].fo_mtx);
+	explicit_bzero(fortuna_output, sizeof(fortuna_output));
+	RANDOM_RESEED_DEINIT_LOCK();
+	explicit_bzero(&fortuna_state, sizeof(fortuna_state));
+}
+
+/*-
+ * Reseed if pool 0 has collected enough and the last reseed was long
+ * enough ago, or if we have never been seeded.
+ */
+static void
+random_fortuna_reseed_check(void)
+{
+	uint64_t now;
+
+	RANDOM_RESEED_ASSERT_LOCK_OWNED();
+	if (fortuna_state.fs_pool[0].fsp_length < fortuna_state.fs_minpoolsize)
+		return;
+	now = random_fortuna_now_ms();
+	if (fortuna_state.fs_seeded &&
+	    now - fortuna_state.fs_lastreseed < RANDOM_FORTUNA_RESEED_MS)
+		return;
+	fortuna_state.fs_lastreseed = now;
+	random_fortuna_reseed_internal();
+}
+
+/*-
+ * Process a single stochastic event off the harvest queue
+ * F&S - AddRandomEvent(s, i, e)
+ */
+static void
+random_fortuna_process_event(struct harvest_event *event)
+{
+	u_int pl;
+
+	RANDOM_RESEED_LOCK();
+	/*
+	 * Accumulate the event into the appropriate pool
+	 * where each event carries the destination information.
+	 */
+	pl = event->he_destination % RANDOM_FORTUNA_NPOOLS;
+	randomdev_hash_iterate(&fortuna_state.fs_pool[pl].fsp_hash, event, sizeof(*event));
+	/* Don't wrap the length. */
+	fortuna_state.fs_pool[pl].fsp_length = MIN(RANDOM_FORTUNA_MAXPOOLSIZE,
+	    fortuna_state.fs_pool[pl].fsp_length + sizeof(event->he_entropy));
+	random_fortuna_reseed_check();
+	explicit_bzero(event, sizeof(*event));
+	RANDOM_RESEED_UNLOCK();
+}
+
+/*-
+ * F&S - Reseed()
+ * Hash the pools due for this reseed into the key.
+ */
+static void
+random_fortuna_reseed_internal(void)
+{
+	struct randomdev_hash context;
+	uint8_t hash[RANDOM_KEYSIZE];
+	u_int i, r;
+
+	RANDOM_RESEED_ASSERT_LOCK_OWNED();
+	/* F&S - ReseedCNT = ReseedCNT + 1; zero is kept for "unkeyed" */
+	if (++fortuna_state.fs_reseedcount == 0)
+		fortuna_state.fs_reseedcount = 1;
+	r = fortuna_state.fs_reseedcount;
+	/* F&S - K = Hd(K|s) where s = Hd(P0)|Hd(P1)|..|Hd(Pn) */
+	randomdev_hash_init(&context);
+	randomdev_hash_iterate(&context, &fortuna_state.fs_key, sizeof(fortuna_state.fs_key));
+	for (i = 0; i < RANDOM_FORTUNA_NPOOLS; i++) {
+		/* F&S - if Divides(R, 2^i) ... */
+		if (i > 0 && (r & ((1U << i) - 1)) != 0)
+			break;
+		randomdev_hash_finish(&fortuna_state.fs_pool[i].fsp_hash, hash);
+		randomdev_hash_iterate(&context, hash, sizeof(hash));
+		/* F&S - P_i = \epsilon */
+		randomdev_hash_init(&fortuna_state.fs_pool[i].fsp_hash);
+		fortuna_state.fs_pool[i].fsp_length = 0;
+	}
+	randomdev_hash_finish(&context, hash);
+	randomdev_encrypt_init(&fortuna_state.fs_key, hash);
+	/* F&S - C = C + 1 */
+	uint128_increment(&fortuna_state.fs_counter);
+	explicit_bzero(hash, sizeof(hash));
+	explicit_bzero(&context, sizeof(context));
+	/* Unblock the device if it was blocked due to being unseeded */
+	if (!fortuna_state.fs_seeded) {
+		fortuna_state.fs_seeded = true;
+		#ifndef __LITEOS__
+		randomdev_unblock();
+		#endif
+	}
+}
+
+/*-
+ * F&S - GenerateRandomData() on the central generator, for a new
+ * output context key: two blocks of output and then, as after every
+ * request, two more to replace the central key.
+ */
+static void
+random_fortuna_genkey(uint8_t key[RANDOM_KEYSIZE])
+{
+	uint8_t newkey[RANDOM_KEYSIZE];
+
+	RANDOM_RESEED_ASSERT_LOCK_OWNED();
+	randomdev_keystream(&fortuna_state.fs_key, &fortuna_state.fs_counter, key, RANDOM_KEYS_PER_BLOCK);
+	randomdev_keystream(&fortuna_state.fs_key, &fortuna_state.fs_counter, newkey, RANDOM_KEYS_PER_BLOCK);
+	randomdev_encrypt_init(&fortuna_state.fs_key, newkey);
+	explicit_bzero(newkey, sizeof(newkey));
+}
+
+/*
+ * The index of the caller's output context: by CPU in the kernel, by
+ * task ID on LiteOS, whose task IDs are small consecutive integers, and
+ * round-robin by thread elsewhere, so that up to RANDOM_FORTUNA_NOUT
+ * readers never share.  Sharing a context is safe, only slower.
+ */
+#if !defined(_KERNEL) && !defined(__LITEOS__)
+static u_int fortuna_next_output;
+static __thread u_int fortuna_thread_output;	/* Index plus one; 0 until first read */
+#endif
+
+u_int
+random_fortuna_output_index(void)
+{
+	u_int t;
+
+#ifdef _KERNEL
+	t = curcpu;
+#elif defined(__LITEOS__)
+	t = LOS_CurTaskIDGet();
+#else
+	if (fortuna_thread_output == 0)
+		fortuna_thread_output = __atomic_fetch_add(&fortuna_next_output,
+		    1, __ATOMIC_RELAXED) + 1;
+	t = fortuna_thread_output - 1;
+#endif
+	return (t & (RANDOM_FORTUNA_NOUT - 1));
+}
+
+/*-
+ * Used to return processed entropy from the PRNG. There is a pre_read
+ * required to be present (but it can be a stub) in order to allow
+ * specific actions at the begin of the read.
+ * Fortuna reseeds here as well as when events arrive, in case events
+ * stop arriving with pool 0 full but reseeds held off by the timer.
+ */
+void
+random_fortuna_pre_read(void)
+{
+
+	RANDOM_RESEED_LOCK();
+	random_fortuna_reseed_check();
+	RANDOM_RESEED_UNLOCK();
+}
+
+/*-
+ * Main read from Fortuna.
+ * The supplied buf MUST be a multiple (>=0) of RANDOM_BLOCKSIZE in size.
+ * Lots of code presumes this for efficiency, both here and in other
+ * routines. You are NOT allowed to break this!
+ *
+ * Only the caller's output context is locked, except to rekey it from
+ * the central generator after a reseed.  Each run of at most
+ * RANDOM_FORTUNA_MAX_READ bytes is one request: one CTR call, and then a
+ * new key for the context, so that output already returned cannot be
+ * recovered from the context later.
+ */
+void
+random_fortuna_read(uint8_t *buf, u_int bytecount)
+{
+	struct fortuna_output *fo;
+	uint8_t newkey[RANDOM_KEYSIZE];
+	u_int blockcount, n, r;
+
+	KASSERT((bytecount % RANDOM_BLOCKSIZE) == 0, ("%s(): bytecount (= %d) must be a multiple of %d", __func__, bytecount, RANDOM_BLOCKSIZE ));
+	fo = &fortuna_output[random_fortuna_output_index()];
+	mtx_lock(&fo->fo_mtx);
+	r = __atomic_load_n(&fortuna_state.fs_reseedcount, __ATOMIC_RELAXED);
+	if (fo->fo_reseedcount == 0 || fo->fo_reseedcount != r) {
+		RANDOM_RESEED_LOCK();
+		random_fortuna_genkey(newkey);
+		fo->fo_reseedcount = fortuna_state.fs_reseedcount;
+		RANDOM_RESEED_UNLOCK();
+		randomdev_encrypt_init(&fo->fo_key, newkey);
+		fo->fo_counter = UINT128_ZERO;
+	}
+	blockcount = howmany(bytecount, RANDOM_BLOCKSIZE);
+	for (; blockcount > 0; blockcount -= n) {
+		n = MIN(blockcount, RANDOM_FORTUNA_MAX_READ/RANDOM_BLOCKSIZE);
+		randomdev_keystream(&fo->fo_key, &fo->fo_counter, buf, n);
+		buf += n*RANDOM_BLOCKSIZE;
+		randomdev_keystream(&fo->fo_key, &fo->fo_counter, newkey, RANDOM_KEYS_PER_BLOCK);
+		randomdev_encrypt_init(&fo->fo_key, newkey);
+	}
+	explicit_bzero(newkey, sizeof(newkey));
+	mtx_unlock(&fo->fo_mtx);
+}
+
+bool
+random_fortuna_seeded(void)
+{
+
+	return (fortuna_state.fs_seeded);
+}
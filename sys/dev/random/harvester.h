@@ -0,0 +1,132 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * LiteOS glue shared by the generators: the initial entropy harvest from
+ * the hardware RNG or the cycle counter, and the driver init hook, all
+ * feeding random_alg_context.  Each of yarrow.c and fortuna.c includes
+ * this once, so that whichever is built as the generator carries it; do
+ * not include it anywhere else.
+ */
+
+#ifndef SYS_DEV_RANDOM_HARVESTER_H_INCLUDED
+#define	SYS_DEV_RANDOM_HARVESTER_H_INCLUDED
+
+#define RANDOM_ITERATE_NUMBER   16
+
+#if defined(LOSCFG_HW_RANDOM_ENABLE)
+void
+random_hw_getnumber(char *pbuf, size_t len)
+{
+	extern void HiRandomHwInit(void);
+	extern void HiRandomHwDeinit(void);
+	extern int HiRandomHwGetNumber(char *buffer, size_t buflen);
+
+	HiRandomHwInit();
+
+	ssize_t ret = HiRandomHwGetNumber((char *)pbuf, len);
+	if (ret != 0) {
+		HiRandomHwDeinit();
+		errno = EIO;
+		return;
+	}
+
+	HiRandomHwDeinit();
+}
+#endif
+
+#if defined(LOSCFG_HW_RANDOM_ENABLE) || defined(LOSCFG_DRIVERS_RANDOM)
+void
+run_harvester_once(const char *pentropy, size_t num)
+{
+	struct harvest_event e;
+	uint64_t data;
+	errno_t err = EOK;
+
+	if (pentropy == NULL) {
+		return;
+	}
+	e.he_somecounter = num;
+	e.he_size = sizeof(e.he_entropy);
+	err = memcpy_s(e.he_entropy, e.he_size, pentropy, e.he_size);
+	if(err != EOK){
+		return;
+	}
+	err = memcpy_s(&data, sizeof(uint64_t), e.he_entropy, sizeof(uint64_t));
+	if(err != EOK){
+		return;
+	}
+	e.he_bits = data % 64 + 60; /* calculate bits */
+	e.he_destination = num;
+	e.he_source = (num + 3) % 3; /* calculate source */
+	e.he_next = NULL;
+	random_alg_context.ra_event_processor(&e);
+}
+#endif
+
+void
+run_harvester_iterate(void *arg __unused)
+{
+#if defined(LOSCFG_HW_RANDOM_ENABLE)
+	int i;
+	char buf[8]; /* store random numbers */
+	for (i = 0; i < RANDOM_ITERATE_NUMBER; i++) {
+		random_hw_getnumber(buf, sizeof(buf));
+		run_harvester_once(buf, i);
+		(void)memset_s(buf, sizeof(buf), 0, sizeof(buf));
+	}
+#elif defined(LOSCFG_DRIVERS_RANDOM)
+	extern VOID LOS_GetCpuCycle(UINT32 *puwCntHi, UINT32 *puwCntLo);
+	int rdata1, rdata2;
+	char buf[8]; /* store random numbers */
+	int i;
+	for (i = 0; i < RANDOM_ITERATE_NUMBER; i++) {
+		LOS_GetCpuCycle(&rdata1, &rdata2);
+		srand((unsigned int)rdata2);
+		rdata1 = (int)rand();
+		rdata2 = (int)rand();
+		(void)memcpy_s(buf, sizeof(int), &rdata1, sizeof(int));
+		(void)memcpy_s(buf + 4, sizeof(int), &rdata2, sizeof(int));
+		run_harvester_once(buf, i);
+	}
+	(void)memset_s(buf, sizeof(buf), 0, sizeof(buf));
+#endif
+}
+
+#if defined(LOSCFG_HW_RANDOM_ENABLE) || defined(LOSCFG_DRIVERS_RANDOM)
+UINT32 OsDriverRandomInit(VOID)
+{
+    random_alg_context.ra_init_alg(NULL);
+    run_harvester_iterate(NULL);
+    return LOS_OK;
+}
+#endif
+
+#endif /* SYS_DEV_RANDOM_HARVESTER_H_INCLUDED */
@@ -106,3 +106,26 @@ randomdev_encrypt(struct randomdev_key *context, const void *d_in, void *d_out,
 
 	rijndael_blockEncrypt(&context->cipher, &context->key, d_in, length*8, d_out);
 }
+
+/* Generate <blockcount> blocks of AES-CTR keystream into <*d_out> with
+ * the key schedule preset in the context.  As with yarrow's counter, the
+ * counter <*ctr> is incremented before each block is encrypted, and is
+ * left at the last value used.  Counter mode lets rijndael work on
+ * several blocks at once.
+ */
+void
+randomdev_keystream(struct randomdev_key *context, uint128_t *ctr, void *d_out, u_int blockcount)
+{
+	cipherInstance cipher;
+	uint8_t iv[RANDOM_BLOCKSIZE];
+
+	if (blockcount == 0)
+		return;
+	uint128_increment(ctr);
+	uint128_enc_be(*ctr, iv);
+	rijndael_cipherInit(&cipher, MODE_CTR, (char *)iv);
+	memset(d_out, 0, blockcount*RANDOM_BLOCKSIZE);
+	rijndael_blockEncrypt(&cipher, &context->key, d_out, blockcount*RANDOM_BLOCKSIZE*8, d_out);
+	uint128_add64(ctr, blockcount - 1);
+	explicit_bzero(&cipher, sizeof(cipher));
+}
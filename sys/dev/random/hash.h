@@ -60,5 +60,6 @@ void randomdev_hash_iterate(struct randomdev_hash *, const void *, size_t);
 void randomdev_hash_finish(struct randomdev_hash *, void *);
 void randomdev_encrypt_init(struct randomdev_key *, const void *);
 void randomdev_encrypt(struct randomdev_key *context, const void *, void *, u_int);
+void randomdev_keystream(struct randomdev_key *context, uint128_t *, void *, u_int);
 
 #endif /* SYS_DEV_RANDOM_HASH_H_INCLUDED */
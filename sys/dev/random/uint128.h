@@ -93,4 +93,25 @@ uint128_is_zero(uint128_t big_uint)
 	return (uint128_equals(big_uint, UINT128_ZERO));
 }
 
+/* Store big_uint as 16 bytes, most significant first. */
+static __inline void
+uint128_enc_be(uint128_t big_uint, void *buf)
+{
+	uint8_t *p = buf;
+	uint64_t hi, lo;
+	int i;
+
+#ifdef USE_REAL_UINT128_T
+	hi = (uint64_t)(big_uint >> 64);
+	lo = (uint64_t)big_uint;
+#else
+	hi = big_uint.u128t_word1;
+	lo = big_uint.u128t_word0;
+#endif
+	for (i = 0; i < 8; i++) {
+		p[i] = (uint8_t)(hi >> (56 - 8*i));
+		p[8 + i] = (uint8_t)(lo >> (56 - 8*i));
+	}
+}
+
 #endif /* SYS_DEV_RANDOM_UINT128_H_INCLUDED */
@@ -0,0 +1,257 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host-side test of the random_alg_context in fortuna.c.  Build with
+ * build.sh and run the result; it needs nothing but pthreads.
+ *
+ * It feeds synthetic events in until the generator reports itself
+ * seeded, checks that output does not repeat, and then times reads of
+ * RANDOM_TEST_CHUNK bytes from 1 to RANDOM_TEST_MAXTHREADS threads.  With
+ * per-thread output contexts the aggregate rate should grow with the
+ * thread count up to the number of CPUs, so it also checks that up to
+ * RANDOM_TEST_NOUT threads are given distinct contexts.
+ */
+
+#include <sys/types.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "unit_test.h"
+
+#include <crypto/rijndael/rijndael-api-fst.h>
+#include <crypto/sha2/sha256.h>
+
+#include <dev/random/hash.h>
+#include <dev/random/randomdev.h>
+#include <dev/random/fortuna.h>
+
+#define	RANDOM_TEST_CHUNK	4096		/* Bytes per read */
+#define	RANDOM_TEST_BYTES	(64 << 20)	/* Bytes read per timing run */
+#define	RANDOM_TEST_MAXTHREADS	8
+#define	RANDOM_TEST_NOUT	16		/* RANDOM_FORTUNA_NOUT */
+
+static int failures;
+
+#define	CHECK(exp, msg) do {						\
+	if (!(exp)) {							\
+		printf("FAIL: %s\n", (msg));				\
+		failures++;						\
+	}								\
+} while (0)
+
+/* fortuna.c calls this on first seeding. */
+void
+randomdev_unblock(void)
+{
+
+	printf("randomdev_unblock() called\n");
+}
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec + ts.tv_nsec / 1e9);
+}
+
+static void
+feed(u_int count)
+{
+	struct harvest_event e;
+	u_int i;
+
+	for (i = 0; i < count; i++) {
+		memset(&e, 0, sizeof(e));
+		e.he_somecounter = get_cyclecount();
+		e.he_entropy[0] = (uint32_t)e.he_somecounter;
+		e.he_entropy[1] = (uint32_t)random();
+		e.he_size = sizeof(e.he_entropy);
+		e.he_bits = 8;
+		e.he_destination = i;
+		e.he_source = RANDOM_CACHED;
+		random_alg_context.ra_event_processor(&e);
+	}
+}
+
+static int
+blockcmp(const void *a, const void *b)
+{
+
+	return (memcmp(a, b, RANDOM_BLOCKSIZE));
+}
+
+static void
+test_seeding(void)
+{
+	u_int events;
+
+	CHECK(!random_alg_context.ra_seeded(), "seeded before any events");
+	for (events = 0; !random_alg_context.ra_seeded() && events < 100000; events++)
+		feed(1);
+	printf("seeded after %u events\n", events);
+	CHECK(random_alg_context.ra_seeded(), "not seeded after 100000 events");
+}
+
+static void
+test_output(void)
+{
+	const size_t len = 1 << 20;
+	struct timespec ts;
+	uint8_t *buf, *sorted;
+	size_t i, dups;
+
+	buf = malloc(2 * len);
+	sorted = malloc(2 * len);
+	if (buf == NULL || sorted == NULL) {
+		perror("malloc");
+		exit(1);
+	}
+	random_alg_context.ra_pre_read();
+	random_alg_context.ra_read(buf, len);
+	random_alg_context.ra_read(buf + len, RANDOM_BLOCKSIZE);
+	/* Past the reseed interval and enough events for a reseed. */
+	ts.tv_sec = 0;
+	ts.tv_nsec = 200 * 1000 * 1000;
+	nanosleep(&ts, NULL);
+	feed(100000);
+	random_alg_context.ra_pre_read();
+	random_alg_context.ra_read(buf + len + RANDOM_BLOCKSIZE, len - RANDOM_BLOCKSIZE);
+	memcpy(sorted, buf, 2 * len);
+	qsort(sorted, 2 * len / RANDOM_BLOCKSIZE, RANDOM_BLOCKSIZE, blockcmp);
+	dups = 0;
+	for (i = RANDOM_BLOCKSIZE; i < 2 * len; i += RANDOM_BLOCKSIZE)
+		if (memcmp(sorted + i - RANDOM_BLOCKSIZE, sorted + i, RANDOM_BLOCKSIZE) == 0)
+			dups++;
+	printf("%zu repeated blocks in %zu\n", dups, 2 * len / RANDOM_BLOCKSIZE);
+	CHECK(dups == 0, "repeated output blocks");
+	free(sorted);
+	free(buf);
+}
+
+static pthread_barrier_t context_barrier;
+
+static void *
+context_reader(void *arg)
+{
+	uint8_t buf[RANDOM_BLOCKSIZE];
+
+	random_alg_context.ra_read(buf, sizeof(buf));
+	*(u_int *)arg = random_fortuna_output_index();
+	/* Keep every thread alive until all have picked a context. */
+	pthread_barrier_wait(&context_barrier);
+	return (NULL);
+}
+
+static void
+test_contexts(void)
+{
+	pthread_t td[RANDOM_TEST_NOUT];
+	u_int index[RANDOM_TEST_NOUT], seen;
+	int i, n;
+
+	for (n = 2; n <= RANDOM_TEST_NOUT; n *= 2) {
+		pthread_barrier_init(&context_barrier, NULL, n);
+		for (i = 0; i < n; i++)
+			if (pthread_create(&td[i], NULL, context_reader, &index[i]) != 0) {
+				perror("pthread_create");
+				exit(1);
+			}
+		seen = 0;
+		for (i = 0; i < n; i++) {
+			pthread_join(td[i], NULL);
+			seen |= 1U << index[i];
+		}
+		pthread_barrier_destroy(&context_barrier);
+		printf("%d threads used %d output contexts\n", n, __builtin_popcount(seen));
+		CHECK(__builtin_popcount(seen) == n, "threads share an output context");
+	}
+}
+
+static void *
+reader(void *arg)
+{
+	uint8_t buf[RANDOM_TEST_CHUNK];
+	size_t done, total;
+
+	total = *(size_t *)arg;
+	for (done = 0; done < total; done += sizeof(buf)) {
+		random_alg_context.ra_pre_read();
+		random_alg_context.ra_read(buf, sizeof(buf));
+	}
+	return (NULL);
+}
+
+static void
+test_throughput(void)
+{
+	pthread_t td[RANDOM_TEST_MAXTHREADS];
+	size_t each;
+	double t;
+	int i, n;
+
+	for (n = 1; n <= RANDOM_TEST_MAXTHREADS; n *= 2) {
+		each = RANDOM_TEST_BYTES / n;
+		t = now();
+		for (i = 0; i < n; i++)
+			if (pthread_create(&td[i], NULL, reader, &each) != 0) {
+				perror("pthread_create");
+				exit(1);
+			}
+		for (i = 0; i < n; i++)
+			pthread_join(td[i], NULL);
+		t = now() - t;
+		printf("%d thread%s: %.1f MB/s\n", n, n == 1 ? " " : "s",
+		    RANDOM_TEST_BYTES / t / 1e6);
+	}
+}
+
+int
+main(void)
+{
+
+	printf("Algorithm: %s, %u pools\n", random_alg_context.ra_ident,
+	    random_alg_context.ra_poolcount);
+	random_alg_context.ra_init_alg(NULL);
+	test_seeding();
+	test_output();
+	test_contexts();
+	test_throughput();
+	random_alg_context.ra_deinit_alg(NULL);
+	printf("%s\n", failures == 0 ? "PASS" : "FAIL");
+	return (failures != 0);
+}
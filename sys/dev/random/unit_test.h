@@ -94,4 +94,53 @@ struct sysctl_ctx_list;
 	}			\
 } while (0)
 
+#ifndef __LITEOS__
+/* Host builds have no <sys/mutex.h>; map the few mtx(9) calls used here. */
+#include <pthread.h>
+
+#ifndef __unused
+#define	__unused	__attribute__((__unused__))
+#endif
+#ifndef __aligned
+#define	__aligned(x)	__attribute__((__aligned__(x)))
+#endif
+
+/* The host C library has no <sys/endian.h> encoders, which sha256c.c uses. */
+static __inline void
+be32enc(void *pp, uint32_t u)
+{
+	uint8_t *p = (uint8_t *)pp;
+
+	p[0] = (u >> 24) & 0xff;
+	p[1] = (u >> 16) & 0xff;
+	p[2] = (u >> 8) & 0xff;
+	p[3] = u & 0xff;
+}
+
+static __inline uint32_t
+be32dec(const void *pp)
+{
+	uint8_t const *p = (uint8_t const *)pp;
+
+	return (((unsigned)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3]);
+}
+
+static __inline void
+be64enc(void *pp, uint64_t u)
+{
+	uint8_t *p = (uint8_t *)pp;
+
+	be32enc(p, (uint32_t)(u >> 32));
+	be32enc(p + 4, (uint32_t)(u & 0xffffffffU));
+}
+
+#define	MTX_DEF		0
+#define	MA_OWNED	0
+#define	mtx_init(m, name, type, opts)	(void)pthread_mutex_init((m), NULL)
+#define	mtx_destroy(m)			(void)pthread_mutex_destroy((m))
+#define	mtx_lock(m)			(void)pthread_mutex_lock((m))
+#define	mtx_unlock(m)			(void)pthread_mutex_unlock((m))
+#define	mtx_assert(m, what)		(void)0
+#endif /* !__LITEOS__ */
+
 #endif /* UNIT_TEST_H_INCLUDED */
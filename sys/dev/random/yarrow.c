@@ -64,7 +64,7 @@ __FBSDID("$FreeBSD$");
 #include <dev/random/yarrow.h>
 #endif /* _KERNEL */
 
-#define RANDOM_ITERATE_NUMBER   16
+#include <dev/random/harvester.h>
 
 #define	RANDOM_YARROW_TIMEBIN	16	/* max value for Pt/t */
 
@@ -376,19 +376,21 @@ random_yarrow_pre_read(void)
 void
 random_yarrow_read(uint8_t *buf, u_int bytecount)
 {
-	u_int blockcount, i;
+	u_int blockcount, n;
 
 	KASSERT((bytecount % RANDOM_BLOCKSIZE) == 0, ("%s(): bytecount (= %d) must be a multiple of %d", __func__, bytecount, RANDOM_BLOCKSIZE ));
 	RANDOM_RESEED_LOCK();
 	blockcount = howmany(bytecount, RANDOM_BLOCKSIZE);
-	for (i = 0; i < blockcount; i++) {
-		if (yarrow_state.ys_outputblocks++ >= yarrow_state.ys_gengateinterval) {
+	/* Each run of blocks between generator gates is one CTR call */
+	for (; blockcount > 0; blockcount -= n) {
+		if (yarrow_state.ys_outputblocks >= yarrow_state.ys_gengateinterval) {
 			random_yarrow_generator_gate();
 			yarrow_state.ys_outputblocks = 0;
 		}
-		uint128_increment(&yarrow_state.ys_counter);
-		randomdev_encrypt(&yarrow_state.ys_key, &yarrow_state.ys_counter, buf, RANDOM_BLOCKSIZE);
-		buf += RANDOM_BLOCKSIZE;
+		n = MIN(blockcount, yarrow_state.ys_gengateinterval - yarrow_state.ys_outputblocks);
+		randomdev_keystream(&yarrow_state.ys_key, &yarrow_state.ys_counter, buf, n);
+		yarrow_state.ys_outputblocks += n;
+		buf += n*RANDOM_BLOCKSIZE;
 	}
 	RANDOM_RESEED_UNLOCK();
 }
@@ -399,91 +401,3 @@ random_yarrow_seeded(void)
 
 	return (yarrow_state.ys_seeded);
 }
-
-#if defined(LOSCFG_HW_RANDOM_ENABLE)
-void
-random_hw_getnumber(char *pbuf, size_t len)
-{
-	extern void HiRandomHwInit(void);
-	extern void HiRandomHwDeinit(void);
-	extern int HiRandomHwGetNumber(char *buffer, size_t buflen);
-
-	HiRandomHwInit();
-
-	ssize_t ret = HiRandomHwGetNumber((char *)pbuf, len);
-	if (ret != 0) {
-		HiRandomHwDeinit();
-		errno = EIO;
-		return;
-	}
-
-	HiRandomHwDeinit();
-}
-#endif
-
-#if defined(LOSCFG_HW_RANDOM_ENABLE) || defined(LOSCFG_DRIVERS_RANDOM)
-void
-run_harvester_once(const char *pentropy, size_t num)
-{
-	struct harvest_event e;
-	uint64_t data;
- 	errno_t err = EOK;
-
-	if (pentropy == NULL) {
-		return;
-	}
-	e.he_somecounter = num;
-	e.he_size = sizeof(e.he_entropy);
-	err = memcpy_s(e.he_entropy, e.he_size, pentropy, e.he_size);
-	if(err != EOK){
-		return;
-	}
-	err = memcpy_s(&data, sizeof(uint64_t), e.he_entropy, sizeof(uint64_t));
-	if(err != EOK){
-		return;
-	}
-	e.he_bits = data % 64 + 60; /* calculate bits */
-	e.he_destination = num;
-	e.he_source = (num + 3) % 3; /* calculate source */
-	e.he_next = NULL;
-	random_alg_context.ra_event_processor(&e);
-}
-#endif
-
-void
-run_harvester_iterate(void *arg __unused)
-{
-#if defined(LOSCFG_HW_RANDOM_ENABLE)
-	int i;
-	char buf[8]; /* store random numbers */
-	for (i = 0; i < RANDOM_ITERATE_NUMBER; i++) {
-		random_hw_getnumber(buf, sizeof(buf));
-		run_harvester_once(buf, i);
-		(void)memset_s(buf, sizeof(buf), 0, sizeof(buf));
-	}
-#elif defined(LOSCFG_DRIVERS_RANDOM)
-	extern VOID LOS_GetCpuCycle(UINT32 *puwCntHi, UINT32 *puwCntLo);
-	int rdata1, rdata2;
-	char buf[8]; /* store random numbers */
-	int i;
-	for (i = 0; i < RANDOM_ITERATE_NUMBER; i++) {
-		LOS_GetCpuCycle(&rdata1, &rdata2);
-		srand((unsigned int)rdata2);
-		rdata1 = (int)rand();
-		rdata2 = (int)rand();
-		(void)memcpy_s(buf, sizeof(int), &rdata1, sizeof(int));
-		(void)memcpy_s(buf + 4, sizeof(int), &rdata2, sizeof(int));
-		run_harvester_once(buf, i);
-	}
-	(void)memset_s(buf, sizeof(buf), 0, sizeof(buf));
-#endif
-}
-
-#if defined(LOSCFG_HW_RANDOM_ENABLE) || defined(LOSCFG_DRIVERS_RANDOM)
-UINT32 OsDriverRandomInit(VOID)
-{
-    random_alg_context.ra_init_alg(NULL);
-    run_harvester_iterate(NULL);
-    return LOS_OK;
-}
-#endif
@@ -49,8 +49,6 @@
 
 #include <sys/cdefs.h>
 
-#include "los_crc32.h"
-
 #include "implementation/global_implementation.h"
 #include "usb_ethernet.h"
 #include "if_cdcereg.h"
@@ -764,7 +762,7 @@ cdce_m_crc32(struct pbuf *m, uint32_t src_offset, uint32_t src_len)
 {
 	uint32_t crc = 0xFFFFFFFF;
 
-	crc = crc32(crc, m->payload, src_len);
+	crc = crc32_raw(m->payload, src_len, crc);
 	return (crc ^ 0xFFFFFFFF);
 }
 
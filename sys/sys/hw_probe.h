@@ -0,0 +1,88 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (c) 2026 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _SYS_HW_PROBE_H_
+#define	_SYS_HW_PROBE_H_
+
+/*
+ * HW_PROBE_ONCE(probe) calls int probe(void), which describes what the CPU
+ * has as a non-negative number, the first time it is reached, and returns
+ * the saved answer after that.  Each use has its own saved answer.  Racing
+ * first callers all store the same answer, so relaxed atomics suffice.
+ */
+static inline int
+hw_probe_once(int *state, int (*probe)(void))
+{
+	int s;
+
+	/* 0 not yet probed, otherwise the answer plus one */
+	if ((s = __atomic_load_n(state, __ATOMIC_RELAXED)) == 0) {
+		s = probe() + 1;
+		__atomic_store_n(state, s, __ATOMIC_RELAXED);
+	}
+	return (s - 1);
+}
+
+#define	HW_PROBE_ONCE(probe) __extension__ ({				\
+	static int __hw_probe_state;					\
+	hw_probe_once(&__hw_probe_state, (probe));			\
+})
+
+#if !defined(_KERNEL) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+
+#define	HW_X86_AVX2	1
+#define	HW_X86_AVX512F	2
+
+/*
+ * HW_X86_AVX512F if the CPU has AVX2 and AVX-512F and the OS saves the
+ * opmask and ZMM state, HW_X86_AVX2 if only AVX2 with YMM state is
+ * usable, else 0.
+ */
+static inline int
+hw_x86_avx_level(void)
+{
+	unsigned int eax, ebx, ecx, edx, xcr0;
+
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) ||
+	    (ecx & (bit_OSXSAVE | bit_AVX)) != (bit_OSXSAVE | bit_AVX))
+		return (0);
+	__asm__ ("xgetbv" : "=a" (xcr0), "=d" (edx) : "c" (0));
+	if ((xcr0 & 6) != 6 ||	/* XMM and YMM state enabled by the OS */
+	    !__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) ||
+	    (ebx & bit_AVX2) == 0)
+		return (0);
+	if ((xcr0 & 0xe0) == 0xe0 && (ebx & bit_AVX512F) != 0)
+		return (HW_X86_AVX512F);
+	return (HW_X86_AVX2);
+}
+#endif
+
+#endif /* !_SYS_HW_PROBE_H_ */
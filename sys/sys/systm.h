@@ -49,4 +49,10 @@
 #define pause(wmesg, timo)	(LOS_TaskDelay(timo))
 
 void        explicit_bzero(void * _Nonnull, size_t);
+
+extern const unsigned int crc32_tab[];
+uint32_t    crc32_raw(const void *, size_t, uint32_t);
+uint32_t    calculate_crc32c(uint32_t, const unsigned char *, unsigned int);
+uint32_t    crc32_raw_combine(uint32_t, uint32_t, uint64_t);
+uint32_t    crc32c_combine(uint32_t, uint32_t, uint64_t);
 #endif /* !_SYS_SYSTM_H_ */